@@ -0,0 +1,166 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+#ifndef __GU_PackedRecastHeightfield_h__
+#define __GU_PackedRecastHeightfield_h__
+
+#include <GU/GU_DetailHandle.h>
+#include <GU/GU_PackedImpl.h>
+#include <UT/UT_BoundingBox.h>
+#include <UT/UT_IntrusivePtr.h>
+#include <UT/UT_Lock.h>
+#include <UT/UT_Matrix4.h>
+
+#include "Recast.h"
+
+class GA_PrimitiveFactory;
+class GA_PrimitiveTypeId;
+class GU_PrimPacked;
+
+namespace HDK_Recast {
+
+/// A filtered heightfield shared between the node that built it and every
+/// packed primitive referencing it. The spans are never changed once it is
+/// shared, so downstream nodes read them directly instead of copying.
+class GU_RecastHeightfieldData : public UT_IntrusiveRefCounter<GU_RecastHeightfieldData>
+{
+public:
+    /// Takes ownership of the heightfield.
+    explicit GU_RecastHeightfieldData(rcHeightfield* hf) : myCompact(hf) {}
+    explicit GU_RecastHeightfieldData(rcHeightfieldTall* hf) : myTall(hf) {}
+    ~GU_RecastHeightfieldData();
+
+    GU_RecastHeightfieldData(const GU_RecastHeightfieldData&) = delete;
+    GU_RecastHeightfieldData& operator=(const GU_RecastHeightfieldData&) = delete;
+
+    /// The heightfield with the given span layout, null if it uses the other one.
+    template<class Layout>
+    const rcHeightfieldT<Layout>* heightfield() const;
+
+    /// Returns true if the spans use the tall layout.
+    bool isTall() const { return myTall != nullptr; }
+
+    int width() const { return isTall() ? myTall->width : myCompact->width; }
+    int height() const { return isTall() ? myTall->height : myCompact->height; }
+    float cellSize() const { return isTall() ? myTall->cs : myCompact->cs; }
+    float cellHeight() const { return isTall() ? myTall->ch : myCompact->ch; }
+
+    /// The world bounds of the grid.
+    void getBounds(UT_BoundingBox& box) const;
+
+    /// The bytes held by the bricks, groups and span pools.
+    int64 getMemoryUsage(bool inclusive) const;
+
+private:
+    rcHeightfield* myCompact = nullptr;
+    rcHeightfieldTall* myTall = nullptr;
+};
+
+typedef UT_IntrusivePtr<const GU_RecastHeightfieldData> GU_RecastHeightfieldHandle;
+
+template<>
+inline const rcHeightfield* GU_RecastHeightfieldData::heightfield<rcSpanLayoutCompact>() const { return myCompact; }
+
+template<>
+inline const rcHeightfieldTall* GU_RecastHeightfieldData::heightfield<rcSpanLayoutTall>() const { return myTall; }
+
+/// A packed primitive referencing a shared heightfield. Copying the primitive,
+/// or the detail holding it, only adds a reference. The span tops are only
+/// built as polygons when the viewport or an unpack asks for them.
+class GU_PackedRecastHeightfield : public GU_PackedImpl
+{
+public:
+    GU_PackedRecastHeightfield();
+    GU_PackedRecastHeightfield(const GU_PackedRecastHeightfield& src);
+    ~GU_PackedRecastHeightfield() override;
+
+    /// Registers the primitive type, called from newGeometryPrim.
+    static void install(GA_PrimitiveFactory* factory);
+
+    /// Returns true once the primitive type is registered.
+    static bool isInstalled();
+
+    /// The type id of the primitive, only valid once installed.
+    static const GA_PrimitiveTypeId& typeId();
+
+    /// Appends a packed primitive referencing data, and its point at the origin.
+    static GU_PrimPacked* build(GU_Detail& gdp, const GU_RecastHeightfieldHandle& data);
+
+    /// The heightfield of the first packed heightfield primitive of gdp, null if there is none.
+    /// If given, count receives the number of packed heightfields on gdp and transform
+    /// the full transform of the one returned, since the spans can't follow either.
+    static GU_RecastHeightfieldHandle findHeightfield(const GU_Detail& gdp, exint* count = nullptr,
+                                                     UT_Matrix4D* transform = nullptr);
+
+    const GU_RecastHeightfieldHandle& data() const { return myData; }
+    void setData(const GU_RecastHeightfieldHandle& data);
+
+    GU_PackedFactory* getFactory() const override;
+    GU_PackedImpl* copy() const override;
+    void clearData() override;
+
+    bool isValid() const override;
+    bool load(GU_PrimPacked* prim, const UT_Options& options, const GA_LoadMap& map) override;
+    void update(GU_PrimPacked* prim, const UT_Options& options) override;
+    bool save(UT_Options& options, const GA_SaveMap& map) const override;
+    bool getBounds(UT_BoundingBox& box) const override;
+    bool getRenderingBounds(UT_BoundingBox& box) const override;
+    void getVelocityRange(UT_Vector3& min, UT_Vector3& max) const override;
+    void getWidthRange(fpreal& wmin, fpreal& wmax) const override;
+    bool unpack(GU_Detail& destgdp, const UT_Matrix4D* transform) const override;
+    GU_ConstDetailHandle getPackedDetail(GU_PackedContext* context = 0) const override;
+
+    int64 getMemoryUsage(bool inclusive) const override;
+    void countMemory(UT_MemoryCounter& counter, bool inclusive) const override;
+
+    /// Intrinsics describing the grid.
+    exint intrinsicWidth(const GU_PrimPacked* prim) const { return myData ? myData->width() : 0; }
+    exint intrinsicHeight(const GU_PrimPacked* prim) const { return myData ? myData->height() : 0; }
+    fpreal intrinsicCellSize(const GU_PrimPacked* prim) const { return myData ? myData->cellSize() : 0; }
+    fpreal intrinsicCellHeight(const GU_PrimPacked* prim) const { return myData ? myData->cellHeight() : 0; }
+    bool intrinsicTall(const GU_PrimPacked* prim) const { return myData && myData->isTall(); }
+
+private:
+    /// The span tops as polygons, built on first use.
+    GU_ConstDetailHandle displayDetail() const;
+
+    GU_RecastHeightfieldHandle myData;
+
+    mutable UT_Lock myDisplayLock;
+    mutable GU_ConstDetailHandle myDisplay;
+};
+} // End HDK_Recast namespace
+
+#endif
@@ -34,17 +34,79 @@
 #include "Recast.h"
 #include "RecastAlloc.h"
 #include "RecastMath.h"
+#include "RecastParallel.h"
 #include <cstring>
+#include <stdarg.h>
+#include <stdio.h>
 
-void rcFreeHeightField(rcHeightfield* hf)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RC_SSE2 1
+#endif
+
+/// @class rcContext
+/// @par
+///
+/// Logging can be disabled with #enableLog. Messages longer than 512 characters
+/// are truncated.
+void rcContext::log(const rcLogCategory category, const char* format, ...)
+{
+    if (!m_logEnabled)
+        return;
+    static const int MSG_SIZE = 512;
+    char msg[MSG_SIZE];
+    va_list ap;
+    va_start(ap, format);
+    int len = vsnprintf(msg, MSG_SIZE, format, ap);
+    va_end(ap);
+    if (len < 0)
+        return;
+    if (len >= MSG_SIZE)
+    {
+        len = MSG_SIZE - 1;
+        msg[MSG_SIZE - 1] = '\0';
+    }
+    doLog(category, msg, len);
+}
+
+void rcCalcBounds(const float* verts, int nv, float* bmin, float* bmax)
+{
+    // Calculate bounding box.
+    rcVcopy(bmin, verts);
+    rcVcopy(bmax, verts);
+    for (int i = 1; i < nv; ++i)
+    {
+        const float* v = &verts[i*3];
+        for (int j = 0; j < 3; ++j)
+        {
+            bmin[j] = rcMin(bmin[j], v[j]);
+            bmax[j] = rcMax(bmax[j], v[j]);
+        }
+    }
+}
+
+void rcCalcGridSize(const float* bmin, const float* bmax, float cs, int* w, int* h)
+{
+    *w = (int)((bmax[0] - bmin[0])/cs+0.5f);
+    *h = (int)((bmax[2] - bmin[2])/cs+0.5f);
+}
+
+template<class Layout>
+void rcFreeHeightField(rcHeightfieldT<Layout>* hf)
 {
     if (!hf) return;
-    // Delete span array.
-    rcFree(hf->spans);
+    // Delete span bricks.
+    if (hf->bricks)
+    {
+        for (int i = 0; i < hf->brickWidth*hf->brickHeight; ++i)
+            rcFree(hf->bricks[i]);
+    }
+    rcFree(hf->bricks);
+    rcFree(hf->groups);
     // Delete span pools.
     while (hf->pools)
     {
-        rcSpanPool* next = hf->pools->next;
+        rcSpanPoolT<Layout>* next = hf->pools->next;
         rcFree(hf->pools);
         hf->pools = next;
     }
@@ -56,14 +118,18 @@ void rcFreeHeightField(rcHeightfield* hf)
     rcFree(hf);
 }
 
-rcHeightfield* rcAllocHeightfield()
+template<class Layout>
+rcHeightfieldT<Layout>* rcAllocHeightfield()
 {
-    rcHeightfield* hf = (rcHeightfield*)rcAlloc(sizeof(rcHeightfield), RC_ALLOC_PERM);
-    memset(hf, 0, sizeof(rcHeightfield));
+    rcHeightfieldT<Layout>* hf = (rcHeightfieldT<Layout>*)rcAlloc(sizeof(rcHeightfieldT<Layout>), RC_ALLOC_PERM);
+    if (!hf)
+        return 0;
+    memset(hf, 0, sizeof(rcHeightfieldT<Layout>));
     return hf;
 }
 
-bool rcCreateHeightfield(rcHeightfield& hf, int width, int height,
+template<class Layout>
+bool rcCreateHeightfield(rcHeightfieldT<Layout>& hf, int width, int height,
                          const float* bmin, const float* bmax,
                          float cs, float ch)
 {
@@ -76,10 +142,25 @@ bool rcCreateHeightfield(rcHeightfield& hf, int width, int height,
     rcVcopy(hf.bmax, bmax);
     hf.cs = cs;
     hf.ch = ch;
-    hf.spans = (rcSpan**)rcAlloc(sizeof(rcSpan*)*hf.width*hf.height, RC_ALLOC_PERM);
-    if (!hf.spans)
+    hf.brickWidth = (width + RC_BRICK_MASK) >> RC_BRICK_SHIFT;
+    hf.brickHeight = (height + RC_BRICK_MASK) >> RC_BRICK_SHIFT;
+    hf.brickCount = 0;
+    hf.bricks = (rcSpanBrickT<Layout>**)rcAlloc(sizeof(rcSpanBrickT<Layout>*)*hf.brickWidth*hf.brickHeight, RC_ALLOC_PERM);
+    if (!hf.bricks)
+        return false;
+    memset(hf.bricks, 0, sizeof(rcSpanBrickT<Layout>*)*hf.brickWidth*hf.brickHeight);
+
+    hf.groupWidth = (hf.brickWidth + RC_GROUP_MASK) >> RC_GROUP_SHIFT;
+    hf.groupHeight = (hf.brickHeight + RC_GROUP_MASK) >> RC_GROUP_SHIFT;
+    hf.groups = (rcBrickGroup*)rcAlloc(sizeof(rcBrickGroup)*hf.groupWidth*hf.groupHeight, RC_ALLOC_PERM);
+    if (!hf.groups)
         return false;
-    memset(hf.spans, 0, sizeof(rcSpan*)*hf.width*hf.height);
+    for (int i = 0; i < hf.groupWidth*hf.groupHeight; ++i)
+    {
+        hf.groups[i].brickMask = 0;
+        hf.groups[i].smin = 0xffff;
+        hf.groups[i].smax = 0;
+    }
     
     hf.EdgeHits = (rcEdgeHit*)rcAlloc(sizeof(rcEdgeHit) * (hf.height + 1), RC_ALLOC_PERM); 
     if (!hf.EdgeHits)
@@ -87,6 +168,8 @@ bool rcCreateHeightfield(rcHeightfield& hf, int width, int height,
     memset(hf.EdgeHits, 0, sizeof(rcEdgeHit) * (hf.height + 1));
 
     hf.RowExt = (rcRowExt*)rcAlloc(sizeof(rcRowExt) * (hf.height + 2), RC_ALLOC_PERM); 
+    if (!hf.RowExt)
+        return false;
 
     for (int i = 0; i < hf.height + 2; i++)
     {
@@ -94,18 +177,428 @@ bool rcCreateHeightfield(rcHeightfield& hf, int width, int height,
         hf.RowExt[i].MaxCol = -2;
     }
 
-    hf.tempspans = (rcTempSpan*)rcAlloc(sizeof(rcTempSpan)*(hf.width + 2) * (hf.height + 2), RC_ALLOC_PERM); 
-    if (!hf.tempspans)
+    // Temp spans are sized to the bounds of each triangle on demand, see rasterizeTri.
+    hf.tempspans = 0;
+    hf.tempspansSize = 0;
+
+    return true;
+}
+
+template<class Layout>
+rcSpanBrickT<Layout>* rcAllocBrick()
+{
+    rcSpanBrickT<Layout>* brick = (rcSpanBrickT<Layout>*)rcAlloc(sizeof(rcSpanBrickT<Layout>), RC_ALLOC_PERM);
+    if (!brick)
+        return 0;
+    memset(brick, 0, sizeof(rcSpanBrickT<Layout>));
+    brick->smin = 0xffff;
+    brick->smax = 0;
+    return brick;
+}
+
+template<class Layout>
+rcSpanT<Layout>** rcAllocColumn(rcHeightfieldT<Layout>& hf, int x, int y)
+{
+    rcSpanBrickT<Layout>*& brick = hf.bricks[rcBrickIndex(hf, x, y)];
+    if (!brick)
+    {
+        brick = rcAllocBrick<Layout>();
+        if (!brick)
+            return 0;
+        hf.brickCount++;
+    }
+    return &brick->spans[rcBrickColumnIndex(x, y)];
+}
+
+template<class Layout>
+size_t rcCompactSpanPools(rcHeightfieldT<Layout>& hf)
+{
+    // Count the live spans and the pools holding them.
+    int spanCount = 0;
+    for (int i = 0; i < hf.brickWidth*hf.brickHeight; ++i)
+    {
+        const rcSpanBrickT<Layout>* brick = hf.bricks[i];
+        if (!brick)
+            continue;
+        for (int c = 0; c < RC_BRICK_SIZE*RC_BRICK_SIZE; ++c)
+        {
+            for (const rcSpanT<Layout>* s = brick->spans[c]; s; s = s->next)
+                spanCount++;
+        }
+    }
+
+    int oldPoolCount = 0;
+    for (const rcSpanPoolT<Layout>* pool = hf.pools; pool; pool = pool->next)
+        oldPoolCount++;
+
+    // Allocate all the new pools up front, so running out of memory leaves hf untouched.
+    const int newPoolCount = (spanCount + RC_SPANS_PER_POOL - 1) / RC_SPANS_PER_POOL;
+    rcSpanPoolT<Layout>* pools = 0;
+    rcSpanPoolT<Layout>** tail = &pools;
+    for (int i = 0; i < newPoolCount; ++i)
+    {
+        rcSpanPoolT<Layout>* pool = (rcSpanPoolT<Layout>*)rcAlloc(sizeof(rcSpanPoolT<Layout>), RC_ALLOC_PERM);
+        if (!pool)
+        {
+            while (pools)
+            {
+                rcSpanPoolT<Layout>* next = pools->next;
+                rcFree(pools);
+                pools = next;
+            }
+            return 0;
+        }
+        pool->next = 0;
+        *tail = pool;
+        tail = &pool->next;
+    }
+
+    // Copy the spans brick by brick, column by column, bottom to top, so
+    // traversals in the same order walk the pools front to back.
+    rcSpanPoolT<Layout>* pool = pools;
+    int item = 0;
+    for (int i = 0; i < hf.brickWidth*hf.brickHeight; ++i)
+    {
+        rcSpanBrickT<Layout>* brick = hf.bricks[i];
+        if (!brick)
+            continue;
+        for (int c = 0; c < RC_BRICK_SIZE*RC_BRICK_SIZE; ++c)
+        {
+            rcSpanT<Layout>** prev = &brick->spans[c];
+            for (const rcSpanT<Layout>* s = brick->spans[c]; s; s = s->next)
+            {
+                if (item == RC_SPANS_PER_POOL)
+                {
+                    pool = pool->next;
+                    item = 0;
+                }
+                rcSpanT<Layout>* copy = &pool->items[item++];
+                copy->data = s->data;
+                *prev = copy;
+                prev = &copy->next;
+            }
+            *prev = 0;
+        }
+    }
+
+    while (hf.pools)
+    {
+        rcSpanPoolT<Layout>* next = hf.pools->next;
+        rcFree(hf.pools);
+        hf.pools = next;
+    }
+    hf.pools = pools;
+
+    // The unused tail of the last pool becomes the freelist.
+    hf.freelist = 0;
+    if (pool)
+    {
+        for (int i = RC_SPANS_PER_POOL - 1; i >= item; --i)
+        {
+            pool->items[i].next = hf.freelist;
+            hf.freelist = &pool->items[i];
+        }
+    }
+
+    return (size_t)(oldPoolCount - newPoolCount) * sizeof(rcSpanPoolT<Layout>);
+}
+
+rcColumnHeightfield* rcAllocColumnHeightfield()
+{
+    rcColumnHeightfield* chf = (rcColumnHeightfield*)rcAlloc(sizeof(rcColumnHeightfield), RC_ALLOC_PERM);
+    if (chf)
+        memset(chf, 0, sizeof(rcColumnHeightfield));
+    return chf;
+}
+
+static void freeColumnArrays(rcColumnHeightfield& chf)
+{
+    rcFree(chf.cells);
+    rcFree(chf.smin);
+    rcFree(chf.smax);
+    rcFree(chf.areas);
+    rcFree(chf.clearance);
+    rcFree(chf.maxClearance);
+    rcFree(chf.cons);
+    rcFree(chf.dist);
+    rcFree(chf.regs);
+    chf.cells = 0;
+    chf.smin = 0;
+    chf.smax = 0;
+    chf.areas = 0;
+    chf.clearance = 0;
+    chf.maxClearance = 0;
+    chf.cons = 0;
+    chf.dist = 0;
+    chf.maxDistance = 0;
+    chf.regs = 0;
+    chf.maxRegions = 0;
+    chf.spanCount = 0;
+}
+
+void rcFreeColumnHeightfield(rcColumnHeightfield* chf)
+{
+    if (!chf)
+        return;
+    freeColumnArrays(*chf);
+    rcFree(chf);
+}
+
+/// Building runs one task item per row of cells.
+template<class Layout>
+struct rcColumnTask
+{
+    const rcHeightfieldT<Layout>* hf;
+    rcColumnHeightfield* chf;
+};
+
+/// Stores the span count of every column in the cell after it, ready for the prefix sum.
+template<class Layout>
+static void countColumnSpans(void* userData, int begin, int end)
+{
+    const rcColumnTask<Layout>& task = *(const rcColumnTask<Layout>*)userData;
+    const rcHeightfieldT<Layout>& hf = *task.hf;
+    unsigned int* cells = task.chf->cells;
+    for (int y = begin; y < end; ++y)
+    {
+        const int by = y >> RC_BRICK_SHIFT;
+        const int ly = y & RC_BRICK_MASK;
+        for (int bx = 0; bx < hf.brickWidth; ++bx)
+        {
+            const rcSpanBrickT<Layout>* brick = hf.bricks[bx + by*hf.brickWidth];
+            if (!brick)
+                continue;
+            for (unsigned int columns = brick->rowMask[ly]; columns; columns &= columns - 1)
+            {
+                const int lx = rcLowestBit(columns);
+                unsigned int count = 0;
+                for (const rcSpanT<Layout>* s = brick->spans[rcBrickColumnIndex(lx, ly)]; s; s = s->next)
+                    count++;
+                cells[(bx << RC_BRICK_SHIFT) + lx + y*hf.width + 1] = count;
+            }
+        }
+    }
+}
+
+template<class Layout>
+static void fillColumnSpans(void* userData, int begin, int end)
+{
+    const rcColumnTask<Layout>& task = *(const rcColumnTask<Layout>*)userData;
+    const rcHeightfieldT<Layout>& hf = *task.hf;
+    rcColumnHeightfield& chf = *task.chf;
+    for (int y = begin; y < end; ++y)
+    {
+        const int by = y >> RC_BRICK_SHIFT;
+        const int ly = y & RC_BRICK_MASK;
+        for (int bx = 0; bx < hf.brickWidth; ++bx)
+        {
+            const rcSpanBrickT<Layout>* brick = hf.bricks[bx + by*hf.brickWidth];
+            if (!brick)
+                continue;
+            for (unsigned int columns = brick->rowMask[ly]; columns; columns &= columns - 1)
+            {
+                const int lx = rcLowestBit(columns);
+                unsigned int i = chf.cells[(bx << RC_BRICK_SHIFT) + lx + y*hf.width];
+                for (const rcSpanT<Layout>* s = brick->spans[rcBrickColumnIndex(lx, ly)]; s; s = s->next, ++i)
+                {
+                    chf.smin[i] = (unsigned short)s->data.smin;
+                    chf.smax[i] = (unsigned short)s->data.smax;
+                    chf.areas[i] = (unsigned char)s->data.area;
+                }
+            }
+        }
+    }
+}
+
+/// Computes the clearance of the spans of the rows [begin, end) in one sweep over the arrays.
+static void sweepClearance(void* userData, int begin, int end)
+{
+    rcColumnHeightfield& chf = *(rcColumnHeightfield*)userData;
+    const unsigned short* smin = chf.smin;
+    const unsigned short* smax = chf.smax;
+    unsigned short* clearance = chf.clearance;
+
+    // The next span in the arrays is the next span of the column for all but the top
+    // spans, so the gaps are computed branch free and the top spans patched after.
+    const unsigned int first = chf.cells[begin*chf.width];
+    const unsigned int last = chf.cells[end*chf.width];
+    // Gaps wrap in 16 bits like the vector lanes, and a gap of #RC_CLEARANCE_OPEN is taken one lower.
+    unsigned int i = first;
+#ifdef RC_SSE2
+    const __m128i open = _mm_set1_epi16((short)RC_CLEARANCE_OPEN);
+    for (; i + 8 <= last; i += 8)
+    {
+        const __m128i above = _mm_loadu_si128((const __m128i*)(smin + i + 1));
+        const __m128i gap = _mm_sub_epi16(above, _mm_loadu_si128((const __m128i*)(smax + i)));
+        _mm_storeu_si128((__m128i*)(clearance + i), _mm_add_epi16(gap, _mm_cmpeq_epi16(gap, open)));
+    }
+#endif
+    for (; i < last; ++i)
+    {
+        const unsigned short gap = (unsigned short)(smin[i + 1] - smax[i]);
+        clearance[i] = (unsigned short)(gap - (gap == RC_CLEARANCE_OPEN));
+    }
+
+    for (int c = begin*chf.width; c < end*chf.width; ++c)
+    {
+        const unsigned int s0 = chf.cells[c];
+        const unsigned int s1 = chf.cells[c + 1];
+        unsigned short best = 0;
+        if (s0 < s1)
+        {
+            for (unsigned int i = s0; i + 1 < s1; ++i)
+                best = rcMax(best, clearance[i]);
+            clearance[s1 - 1] = RC_CLEARANCE_OPEN;
+        }
+        chf.maxClearance[c] = best;
+    }
+}
+
+/// @par
+///
+/// The columns are counted and filled in parallel over rows with #rcParallelFor,
+/// with a prefix sum over the counts in between, and the clearance is then
+/// computed from the arrays alone.
+///
+/// @see rcAllocColumnHeightfield, rcColumnHeightfield
+template<class Layout>
+bool rcBuildColumnHeightfield(const rcHeightfieldT<Layout>& hf, rcColumnHeightfield& chf)
+{
+    freeColumnArrays(chf);
+    chf.width = hf.width;
+    chf.height = hf.height;
+    rcVcopy(chf.bmin, hf.bmin);
+    rcVcopy(chf.bmax, hf.bmax);
+    chf.cs = hf.cs;
+    chf.ch = hf.ch;
+
+    const int ncells = hf.width*hf.height;
+    chf.cells = (unsigned int*)rcAlloc(sizeof(unsigned int)*(ncells + 1), RC_ALLOC_PERM);
+    chf.maxClearance = (unsigned short*)rcAlloc(sizeof(unsigned short)*(ncells + 1), RC_ALLOC_PERM);
+    if (!chf.cells || !chf.maxClearance)
+    {
+        freeColumnArrays(chf);
         return false;
+    }
+    memset(chf.cells, 0, sizeof(unsigned int)*(ncells + 1));
 
-    for (int i = 0; i < hf.height + 2; i++)
+    rcColumnTask<Layout> task = { &hf, &chf };
+    rcParallelFor(hf.height, RC_BRICK_SIZE, countColumnSpans<Layout>, &task);
+    for (int i = 0; i < ncells; ++i)
+        chf.cells[i + 1] += chf.cells[i];
+    chf.spanCount = (int)chf.cells[ncells];
+
+    // One more lower limit, so the sweep can read past the last span.
+    const int nspans = chf.spanCount + 1;
+    chf.smin = (unsigned short*)rcAlloc(sizeof(unsigned short)*nspans, RC_ALLOC_PERM);
+    chf.smax = (unsigned short*)rcAlloc(sizeof(unsigned short)*nspans, RC_ALLOC_PERM);
+    chf.areas = (unsigned char*)rcAlloc(sizeof(unsigned char)*nspans, RC_ALLOC_PERM);
+    chf.clearance = (unsigned short*)rcAlloc(sizeof(unsigned short)*nspans, RC_ALLOC_PERM);
+    if (!chf.smin || !chf.smax || !chf.areas || !chf.clearance)
     {
-        for (int j = 0; j < hf.width + 2; j++)
+        freeColumnArrays(chf);
+        return false;
+    }
+    chf.smin[chf.spanCount] = 0;
+
+    rcParallelFor(hf.height, RC_BRICK_SIZE, fillColumnSpans<Layout>, &task);
+    rcParallelFor(hf.height, RC_BRICK_SIZE, sweepClearance, &chf);
+    return true;
+}
+
+/// Connecting runs one task item per row of cells.
+struct rcConnectTask
+{
+    rcColumnHeightfield* chf;
+    int walkableHeight;
+    int walkableClimb;
+};
+
+/// The top of the open space above span i, open spans reach past any floor.
+static inline int spanTop(const rcColumnHeightfield& chf, unsigned int i)
+{
+    return chf.clearance[i] == RC_CLEARANCE_OPEN ? 0x7fffffff : (int)chf.smax[i] + chf.clearance[i];
+}
+
+static void connectColumns(void* userData, int begin, int end)
+{
+    const rcConnectTask& task = *(const rcConnectTask*)userData;
+    rcColumnHeightfield& chf = *task.chf;
+    const int w = chf.width;
+    const int h = chf.height;
+    for (int y = begin; y < end; ++y)
+    {
+        for (int x = 0; x < w; ++x)
         {
-            hf.tempspans[i * (hf.width + 2) + j].sminmax[0] = 32000;
-            hf.tempspans[i * (hf.width + 2) + j].sminmax[1] = -32000;
+            const int c = x + y*w;
+            const unsigned int s0 = chf.cells[c];
+            const unsigned int s1 = chf.cells[c + 1];
+            for (int dir = 0; dir < 4; ++dir)
+            {
+                const int nx = x + rcGetDirOffsetX(dir);
+                const int ny = y + rcGetDirOffsetY(dir);
+                unsigned int n0 = 0, n1 = 0;
+                if (nx >= 0 && ny >= 0 && nx < w && ny < h)
+                {
+                    n0 = chf.cells[nx + ny*w];
+                    n1 = chf.cells[nx + ny*w + 1];
+                }
+
+                // The floors of both columns rise, so the first neighbour within
+                // climb only moves up, and the walk is linear in the spans.
+                unsigned int first = n0;
+                for (unsigned int i = s0; i < s1; ++i)
+                {
+                    const int floor = chf.smax[i];
+                    const int top = spanTop(chf, i);
+                    while (first < n1 && (int)chf.smax[first] < floor - task.walkableClimb)
+                        first++;
+
+                    unsigned short con = RC_NOT_CONNECTED;
+                    const unsigned int last = rcMin(n1, n0 + RC_NOT_CONNECTED);
+                    for (unsigned int k = first; k < last && (int)chf.smax[k] <= floor + task.walkableClimb; ++k)
+                    {
+                        // Enough open space where both spans meet.
+                        const int bot = rcMax(floor, (int)chf.smax[k]);
+                        if (rcMin(top, spanTop(chf, k)) - bot >= task.walkableHeight)
+                        {
+                            con = (unsigned short)(k - n0);
+                            break;
+                        }
+                    }
+                    chf.cons[i*4 + dir] = con;
+                }
+            }
         }
     }
+}
 
+/// @par
+///
+/// A span connects to the lowest span of the neighbour column whose floor is within
+/// @p walkableClimb of its own and which leaves @p walkableHeight of open space where
+/// the two meet, as in the compact heightfield of Recast. Only the lowest
+/// #RC_NOT_CONNECTED spans of a column can be connected to.
+///
+/// @see rcBuildColumnHeightfield, rcErodeWalkableArea, rcBuildDistanceField
+bool rcBuildColumnConnections(const int walkableHeight, const int walkableClimb, rcColumnHeightfield& chf)
+{
+    rcFree(chf.cons);
+    chf.cons = (unsigned short*)rcAlloc(sizeof(unsigned short)*4*(chf.spanCount + 1), RC_ALLOC_PERM);
+    if (!chf.cons)
+        return false;
+
+    rcConnectTask task = { &chf, walkableHeight, walkableClimb };
+    rcParallelFor(chf.height, RC_BRICK_SIZE, connectColumns, &task);
     return true;
-}
\ No newline at end of file
+}
+
+#define RC_INSTANTIATE_HEIGHTFIELD(Layout) \
+    template rcHeightfieldT<Layout>* rcAllocHeightfield<Layout>(); \
+    template bool rcCreateHeightfield<Layout>(rcHeightfieldT<Layout>&, int, int, const float*, const float*, float, float); \
+    template void rcFreeHeightField<Layout>(rcHeightfieldT<Layout>*); \
+    template rcSpanBrickT<Layout>* rcAllocBrick<Layout>(); \
+    template rcSpanT<Layout>** rcAllocColumn<Layout>(rcHeightfieldT<Layout>&, int, int); \
+    template size_t rcCompactSpanPools<Layout>(rcHeightfieldT<Layout>&); \
+    template bool rcBuildColumnHeightfield<Layout>(const rcHeightfieldT<Layout>&, rcColumnHeightfield&);
+RC_FOR_EACH_SPAN_LAYOUT(RC_INSTANTIATE_HEIGHTFIELD)
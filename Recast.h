@@ -34,11 +34,58 @@
 #ifndef RECAST_H
 #define RECAST_H
 
+#include <stddef.h>
+
 /// The default area id used to indicate a walkable polygon. 
 /// This is also the maximum allowed area id, and the only non-null area id 
 /// recognized by some steps in the build process. 
 static const unsigned char RC_WALKABLE_AREA = 63;
 
+/// Represents the null area.
+/// When a data element is given this value it is considered to no longer be 
+/// assigned to a usable area.  (E.g. It is unwalkable.)
+static const unsigned char RC_NULL_AREA = 0;
+
+/// Recast log categories.
+/// @see rcContext
+enum rcLogCategory
+{
+	RC_LOG_PROGRESS = 1,	///< A progress log entry.
+	RC_LOG_WARNING,			///< A warning log entry.
+	RC_LOG_ERROR			///< An error log entry.
+};
+
+/// Provides an interface for optional logging of the build steps.
+/// The default implementation discards every message; derive from it and override
+/// #doLog to forward them.
+class rcContext
+{
+public:
+	/// Constructor.
+	///  @param[in]		state	TRUE if the logging should be enabled.
+	inline rcContext(bool state = true) : m_logEnabled(state) {}
+	virtual ~rcContext() {}
+
+	/// Enables or disables logging.
+	///  @param[in]		state	TRUE if logging should be enabled.
+	inline void enableLog(bool state) { m_logEnabled = state; }
+
+	/// Logs a message.
+	///  @param[in]		category	The category of the message.
+	///  @param[in]		format		The message, formatted like printf.
+	void log(const rcLogCategory category, const char* format, ...);
+
+protected:
+	/// Logs a message.
+	///  @param[in]		category	The category of the message.
+	///  @param[in]		msg			The formatted message.
+	///  @param[in]		len			The length of the formatted message.
+	virtual void doLog(const rcLogCategory /*category*/, const char* /*msg*/, const int /*len*/) {}
+
+	/// True if logging is enabled.
+	bool m_logEnabled;
+};
+
 struct rcRowExt
 {
 	int MinCol;
@@ -48,40 +95,114 @@ struct rcEdgeHit
 {
 	unsigned char Hits[2];
 };
-struct rcTempSpan
+
+static const int RC_SPANS_PER_POOL = 2048;
+
+/// The heightfield columns are stored in square bricks of (1<<RC_BRICK_SHIFT) columns per side.
+static const int RC_BRICK_SHIFT = 5;
+static const int RC_BRICK_SIZE = 1<<RC_BRICK_SHIFT;
+static const int RC_BRICK_MASK = RC_BRICK_SIZE-1;
+
+/// Non-zero to store the columns of a brick in Morton order, zero for row-major order.
+/// Bricks already keep nearby columns together; the passes walk bricks row by row,
+/// which suits row-major order best.
+/// @see rcBrickColumnIndex
+#ifndef RC_MORTON_BRICK_COLUMNS
+#define RC_MORTON_BRICK_COLUMNS 0
+#endif
+
+/// Bricks are summarized in square groups of (1<<RC_GROUP_SHIFT) bricks per side.
+static const int RC_GROUP_SHIFT = 3;
+static const int RC_GROUP_SIZE = 1<<RC_GROUP_SHIFT;
+static const int RC_GROUP_MASK = RC_GROUP_SIZE-1;
+
+/// Span layout packing 13 bit heights and a 6 bit area id into 32 bits.
+/// @see rcHeightfieldT
+struct rcSpanLayoutCompact
 {
-	short int sminmax[2];			///< The lower and upper limit of the span. [Limit: < #smax]
+	static const int HeightBits = 13;		///< The number of bits of rcSpanDataT::smin and rcSpanDataT::smax.
+	static const int AreaBits = 6;			///< The number of bits of rcSpanDataT::area.
+	static const int MaxHeight = (1<<HeightBits)-1;	///< The maximum value for rcSpanDataT::smin and rcSpanDataT::smax.
+	static const int TempLimit = 32000;		///< The magnitude limit of the rasterizer's temp samples.
+	typedef short int TempType;				///< The type of the rasterizer's temp samples.
 };
 
-static const int RC_SPAN_HEIGHT_BITS = 13;
-static const int RC_SPANS_PER_POOL = 2048;
+/// Span layout with 16 bit heights and an 8 bit area id, for levels taller than
+/// #rcSpanLayoutCompact allows. On 64 bit targets the spans are no larger, as
+/// rcSpanT is padded to the alignment of its next pointer either way.
+/// @see rcHeightfieldT
+struct rcSpanLayoutTall
+{
+	static const int HeightBits = 16;		///< The number of bits of rcSpanDataT::smin and rcSpanDataT::smax.
+	static const int AreaBits = 8;			///< The number of bits of rcSpanDataT::area.
+	static const int MaxHeight = (1<<HeightBits)-1;	///< The maximum value for rcSpanDataT::smin and rcSpanDataT::smax.
+	static const int TempLimit = 1<<20;		///< The magnitude limit of the rasterizer's temp samples.
+	typedef int TempType;					///< The type of the rasterizer's temp samples.
+};
+
+/// Calls MACRO(Layout) once per supported span layout, e.g. to explicitly instantiate templates.
+#define RC_FOR_EACH_SPAN_LAYOUT(MACRO) \
+	MACRO(rcSpanLayoutCompact) \
+	MACRO(rcSpanLayoutTall)
+
+template<class Layout>
+struct rcTempSpanT
+{
+	typename Layout::TempType sminmax[2];			///< The lower and upper limit of the span. [Limit: < #smax]
+};
 
 /// Represents data of span in a heightfield.
-/// @see rcHeightfield
-struct rcSpanData
+/// @see rcHeightfieldT
+template<class Layout>
+struct rcSpanDataT
 {
-	unsigned int smin : RC_SPAN_HEIGHT_BITS;	///< The lower limit of the span. [Limit: < #smax]
-	unsigned int smax : RC_SPAN_HEIGHT_BITS;	///< The upper limit of the span. [Limit: <= #RC_SPAN_MAX_HEIGHT]
-	unsigned int area : 6;			///< The area id assigned to the span.
+	unsigned int smin : Layout::HeightBits;	///< The lower limit of the span. [Limit: < #smax]
+	unsigned int smax : Layout::HeightBits;	///< The upper limit of the span. [Limit: <= Layout::MaxHeight]
+	unsigned int area : Layout::AreaBits;	///< The area id assigned to the span.
 };
 
 /// Represents a span in a heightfield.
-/// @see rcHeightfield
-struct rcSpan
+/// @see rcHeightfieldT
+template<class Layout>
+struct rcSpanT
 {
-	rcSpanData data;				///< Span data.
-	rcSpan* next;					///< The next span higher up in column.
+	rcSpanDataT<Layout> data;		///< Span data.
+	rcSpanT* next;					///< The next span higher up in column.
 };
 
 /// A memory pool used for quick allocation of spans within a heightfield.
-/// @see rcHeightfield
-struct rcSpanPool
+/// @see rcHeightfieldT
+template<class Layout>
+struct rcSpanPoolT
+{
+	rcSpanPoolT* next;					///< The next span pool.
+	rcSpanT<Layout> items[RC_SPANS_PER_POOL];	///< Array of spans in the pool.
+};
+
+/// A square block of span columns. Bricks are only allocated once a span lands in them.
+/// @see rcHeightfieldT
+template<class Layout>
+struct rcSpanBrickT
+{
+	rcSpanT<Layout>* spans[RC_BRICK_SIZE*RC_BRICK_SIZE];	///< Column heads, indexed by #rcBrickColumnIndex.
+	unsigned int rowMask[RC_BRICK_SIZE];	///< Bit (x & #RC_BRICK_MASK) of row (y & #RC_BRICK_MASK) is set if the column has spans.
+	unsigned short smin;	///< The lowest span minimum in the brick.
+	unsigned short smax;	///< The highest span maximum in the brick.
+};
+
+/// Occupancy summary of a square group of bricks, the coarse level of the occupancy pyramid.
+/// @see rcHeightfieldT
+struct rcBrickGroup
 {
-	rcSpanPool* next;					///< The next span pool.
-	rcSpan items[RC_SPANS_PER_POOL];	///< Array of spans in the pool.
+	unsigned long long brickMask;	///< Bit (bx & #RC_GROUP_MASK) + (by & #RC_GROUP_MASK)*#RC_GROUP_SIZE is set if the brick has spans.
+	unsigned short smin;	///< The lowest span minimum in the group.
+	unsigned short smax;	///< The highest span maximum in the group.
 };
 
-struct rcHeightfield
+/// A dynamic heightfield representing obstructed space.
+/// The span bit layout is chosen by @p Layout, see #rcSpanLayoutCompact and #rcSpanLayoutTall.
+template<class Layout>
+struct rcHeightfieldT
 {
 	int width;			///< The width of the heightfield. (Along the x-axis in cell units.)
 	int height;			///< The height of the heightfield. (Along the z-axis in cell units.)
@@ -89,31 +210,528 @@ struct rcHeightfield
 	float bmax[3];		///< The maximum bounds in world space. [(x, y, z)]
 	float cs;			///< The size of each cell. (On the xz-plane.)
 	float ch;			///< The height of each cell. (The minimum increment along the y-axis.)
-	rcSpan** spans;		///< Heightfield of spans (width*height).
-	rcSpanPool* pools;	///< Linked list of span pools.
-	rcSpan* freelist;	///< The next free span.
+	int brickWidth;		///< The number of bricks along the x-axis.
+	int brickHeight;	///< The number of bricks along the z-axis.
+	int brickCount;		///< The number of allocated bricks.
+	rcSpanBrickT<Layout>** bricks;	///< Sparse grid of span bricks (brickWidth*brickHeight), null where empty.
+	int groupWidth;		///< The number of brick groups along the x-axis.
+	int groupHeight;	///< The number of brick groups along the z-axis.
+	rcBrickGroup* groups;	///< Occupancy of the brick groups (groupWidth*groupHeight).
+	rcSpanPoolT<Layout>* pools;	///< Linked list of span pools.
+	rcSpanT<Layout>* freelist;	///< The next free span.
 
 	rcEdgeHit* EdgeHits; ///< h + 1 bit flags that indicate what edges cross the z cell boundaries
 	rcRowExt* RowExt;		///< h structs that give the current x range for this z row
-	rcTempSpan* tempspans;		///< Heightfield of temp spans (width*height).
+	rcTempSpanT<Layout>* tempspans;		///< Temp spans covering the bounds of the triangle being rasterized.
+	int tempspansSize;	///< The number of allocated temp spans.
+	int tempx0;			///< The column mapped to the first temp span of a row, minus one.
+	int tempy0;			///< The row mapped to the first temp span row, minus one.
+	int tempstride;		///< The number of temp spans per row.
 };
 
-rcHeightfield* rcAllocHeightfield();
-bool rcCreateHeightfield(rcHeightfield& hf, int width, int height,
+typedef rcSpanDataT<rcSpanLayoutCompact> rcSpanData;
+typedef rcSpanT<rcSpanLayoutCompact> rcSpan;
+typedef rcSpanPoolT<rcSpanLayoutCompact> rcSpanPool;
+typedef rcSpanBrickT<rcSpanLayoutCompact> rcSpanBrick;
+typedef rcHeightfieldT<rcSpanLayoutCompact> rcHeightfield;
+typedef rcHeightfieldT<rcSpanLayoutTall> rcHeightfieldTall;
+
+static const int RC_SPAN_HEIGHT_BITS = rcSpanLayoutCompact::HeightBits;
+
+/// Defines the maximum value for rcSpan::smin and rcSpan::smax.
+static const int RC_SPAN_MAX_HEIGHT = rcSpanLayoutCompact::MaxHeight;
+
+/// Calculates the bounding box of an array of vertices.
+///  @param[in]		verts	An array of vertices. [(x, y, z) * @p nv]
+///  @param[in]		nv		The number of vertices in the @p verts array.
+///  @param[out]	bmin	The minimum bounds of the AABB. [(x, y, z)] [Units: wu]
+///  @param[out]	bmax	The maximum bounds of the AABB. [(x, y, z)] [Units: wu]
+void rcCalcBounds(const float* verts, int nv, float* bmin, float* bmax);
+
+/// Calculates the grid size based on the bounding box and grid cell size.
+///  @param[in]		bmin	The minimum bounds of the AABB. [(x, y, z)] [Units: wu]
+///  @param[in]		bmax	The maximum bounds of the AABB. [(x, y, z)] [Units: wu]
+///  @param[in]		cs		The xz-plane cell size. [Limit: > 0] [Units: wu]
+///  @param[out]	w		The width along the x-axis. [Limit: >= 0] [Units: vx]
+///  @param[out]	h		The height along the z-axis. [Limit: >= 0] [Units: vx]
+void rcCalcGridSize(const float* bmin, const float* bmax, float cs, int* w, int* h);
+
+template<class Layout = rcSpanLayoutCompact>
+rcHeightfieldT<Layout>* rcAllocHeightfield();
+
+template<class Layout>
+bool rcCreateHeightfield(rcHeightfieldT<Layout>& hf, int width, int height,
 						 const float* bmin, const float* bmax,
 						 float cs, float ch);
 
-void rcFreeHeightField(rcHeightfield* hf);
+template<class Layout>
+void rcFreeHeightField(rcHeightfieldT<Layout>* hf);
 
-/// Defines the maximum value for rcSpan::smin and rcSpan::smax.
-static const int RC_SPAN_MAX_HEIGHT = (1<<RC_SPAN_HEIGHT_BITS)-1;
+/// Moves the live spans of @p hf into as few span pools as will hold them and frees
+/// the old pools, dropping the holes left by merged spans. The spans are laid out
+/// brick by brick, in #rcBrickColumnIndex order within each brick.
+/// Span pointers into @p hf are invalidated.
+///  @param[in,out]	hf		The heightfield to compact.
+///  @return The number of bytes released, or 0 if out of memory, in which case @p hf is unchanged.
+template<class Layout>
+size_t rcCompactSpanPools(rcHeightfieldT<Layout>& hf);
+
+/// The clearance of a span with no span above it.
+static const unsigned short RC_CLEARANCE_OPEN = 0xffff;
+
+/// The connection of a span with no traversable neighbour in that direction.
+static const unsigned short RC_NOT_CONNECTED = 0xffff;
+
+/// A heightfield flattened into arrays for linear sweeps. The columns are in row major
+/// order and the spans of each column are contiguous, bottom to top, with every span
+/// field in its own array.
+/// @see rcBuildColumnHeightfield
+struct rcColumnHeightfield
+{
+	int width;			///< The width of the heightfield. (Along the x-axis in cell units.)
+	int height;			///< The height of the heightfield. (Along the z-axis in cell units.)
+	float bmin[3];		///< The minimum bounds in world space. [(x, y, z)]
+	float bmax[3];		///< The maximum bounds in world space. [(x, y, z)]
+	float cs;			///< The size of each cell. (On the xz-plane.)
+	float ch;			///< The height of each cell. (The minimum increment along the y-axis.)
+	int spanCount;		///< The number of spans.
+	unsigned int* cells;	///< The first span of every column, and one past the last span. [Size: width*height + 1]
+	unsigned short* smin;	///< The lower limit of every span. [Size: #spanCount + 1]
+	unsigned short* smax;	///< The upper limit of every span. [Size: #spanCount]
+	unsigned char* areas;	///< The area id of every span. [Size: #spanCount]
+	unsigned short* clearance;	///< The open height above every span, up to the next span or #RC_CLEARANCE_OPEN. [Size: #spanCount]
+	unsigned short* maxClearance;	///< The largest clearance below the top span of every column, 0 without. [Size: width*height]
+	unsigned short* cons;	///< The neighbour of every span per direction, as a span of the neighbour column counted from its bottom, or #RC_NOT_CONNECTED. [Size: 4*#spanCount]
+	unsigned short* dist;	///< The distance of every span to the nearest boundary, 2 per cell. [Size: #spanCount]
+	unsigned short maxDistance;	///< The largest value of #dist.
+	unsigned short* regs;	///< The region id of every span, 0 for unwalkable spans. [Size: #spanCount]
+	unsigned short maxRegions;	///< The largest region id of any span.
+};
+
+/// Allocates a column heightfield, to be filled by #rcBuildColumnHeightfield.
+///  @return The column heightfield, or null if out of memory.
+rcColumnHeightfield* rcAllocColumnHeightfield();
+
+/// Frees a column heightfield allocated with #rcAllocColumnHeightfield.
+void rcFreeColumnHeightfield(rcColumnHeightfield* chf);
+
+/// Flattens the spans of @p hf into @p chf and computes their clearance.
+/// The arrays of a previous build of @p chf are freed.
+///  @param[in]		hf		The heightfield.
+///  @param[in,out]	chf		The column heightfield.
+///  @return False if out of memory.
+template<class Layout>
+bool rcBuildColumnHeightfield(const rcHeightfieldT<Layout>& hf, rcColumnHeightfield& chf);
+
+/// Connects every span of @p chf to the spans an agent can step to in the four
+/// neighbour columns. Rows are processed in parallel through #rcParallelFor.
+///  @param[in]		walkableHeight	Minimum floor to 'ceiling' height that will still allow the floor area to 
+///  								be considered walkable. [Limit: >= 3] [Units: vx]
+///  @param[in]		walkableClimb	Maximum ledge height that is considered to still be traversable. 
+///  								[Limit: >=0] [Units: vx]
+///  @param[in,out]	chf				A built column heightfield.
+///  @return False if out of memory.
+bool rcBuildColumnConnections(const int walkableHeight, const int walkableClimb, rcColumnHeightfield& chf);
+
+/// Marks the walkable spans within @p radius of a boundary as not walkable.
+/// A boundary is an unwalkable span or a walkable span missing a walkable neighbour.
+///  @param[in]		radius		The radius of erosion. [Limits: 0 < value < 255] [Units: vx]
+///  @param[in,out]	chf			A column heightfield with connections.
+///  @return False if out of memory.
+/// @see rcBuildColumnConnections
+bool rcErodeWalkableArea(int radius, rcColumnHeightfield& chf);
+
+/// Computes the distance of every span to the nearest boundary into #rcColumnHeightfield::dist.
+/// A boundary is an unwalkable span or a walkable span missing a neighbour with its area.
+///  @param[in,out]	chf			A column heightfield with connections.
+///  @return False if out of memory.
+/// @see rcBuildColumnConnections
+bool rcBuildDistanceField(rcColumnHeightfield& chf);
+
+/// Groups the connected walkable spans of each area into regions, numbered from 1
+/// into #rcColumnHeightfield::regs. Spans are connected if either one connects to the
+/// other. Tiles of the grid are flooded in parallel through #rcParallelFor, and the
+/// regions crossing tile borders are joined after.
+///  @param[in,out]	ctx		The build context to use during the operation.
+///  @param[in,out]	chf		A column heightfield with connections.
+///  @return False if out of memory or if there are more than 0xffff regions, logged through @p ctx.
+/// @see rcBuildColumnConnections
+bool rcBuildColumnRegions(rcContext* ctx, rcColumnHeightfield& chf);
+
+/// The bits of a contour vertex flag word holding the region across the edge.
+static const int RC_CONTOUR_REG_MASK = 0xffff;
+
+/// Set in a contour vertex flag word when the edge borders another walkable area.
+static const int RC_AREA_BORDER = 0x20000;
 
-void rasterizeTri(const float* v0, const float* v1, const float* v2,
-						 const unsigned char area, rcHeightfield& hf,
+/// A closed contour around a region, in cell coordinates of the heightfield.
+/// Outlines wind counterclockwise seen from above, holes clockwise.
+/// @see rcContourSet
+struct rcContour
+{
+	int* verts;			///< The simplified vertices. [(x, y, z, flags) * #nverts]
+	int nverts;			///< The number of simplified vertices.
+	int* rverts;		///< The raw vertices, one per cell edge. [(x, y, z, flags) * #nrverts]
+	int nrverts;		///< The number of raw vertices.
+	unsigned short reg;	///< The region id of the contour.
+	unsigned char area;	///< The area id of the contour.
+};
+
+/// The contours of the regions of a column heightfield.
+/// @see rcBuildContours
+struct rcContourSet
+{
+	rcContour* conts;	///< The contours. [Size: #nconts]
+	int nconts;			///< The number of contours.
+	float bmin[3];		///< The minimum bounds in world space. [(x, y, z)]
+	float bmax[3];		///< The maximum bounds in world space. [(x, y, z)]
+	float cs;			///< The size of each cell. (On the xz-plane.)
+	float ch;			///< The height of each cell. (The minimum increment along the y-axis.)
+	int width;			///< The width of the heightfield. (Along the x-axis in cell units.)
+	int height;			///< The height of the heightfield. (Along the z-axis in cell units.)
+	float maxError;		///< The max edge error the contours were simplified with. [Units: vx]
+};
+
+/// Allocates a contour set, to be filled by #rcBuildContours.
+///  @return The contour set, or null if out of memory.
+rcContourSet* rcAllocContourSet();
+
+/// Frees a contour set allocated with #rcAllocContourSet.
+void rcFreeContourSet(rcContourSet* cset);
+
+/// Traces the boundaries of the regions of @p chf into closed contours and simplifies them.
+/// The contours of a previous build of @p cset are freed.
+///  @param[in,out]	ctx			The build context to use during the operation.
+///  @param[in]		chf			A column heightfield with regions.
+///  @param[in]		maxError	The furthest the simplified edges may stray from the raw contour. [Limit: >=0] [Units: vx]
+///  @param[in]		maxEdgeLen	The longest simplified edge along a wall or area border, 0 for no limit. [Limit: >=0] [Units: vx]
+///  @param[out]	cset		The contours.
+///  @return False if out of memory.
+/// @see rcBuildColumnRegions
+bool rcBuildContours(rcContext* ctx, const rcColumnHeightfield& chf, const float maxError, const int maxEdgeLen, rcContourSet& cset);
+
+/// Returns the index of the brick holding the column at (x, y).
+template<class Layout>
+inline int rcBrickIndex(const rcHeightfieldT<Layout>& hf, int x, int y)
+{
+	return (x >> RC_BRICK_SHIFT) + (y >> RC_BRICK_SHIFT)*hf.brickWidth;
+}
+
+/// Returns the index of the column at (x, y) inside its brick.
+/// With #RC_MORTON_BRICK_COLUMNS the columns of a brick are in Morton (z-curve) order,
+/// so the column heads of both x and y neighbours are usually a cache line apart.
+inline int rcBrickColumnIndex(int x, int y)
+{
+#if RC_MORTON_BRICK_COLUMNS
+	unsigned int ix = x & RC_BRICK_MASK;
+	unsigned int iy = y & RC_BRICK_MASK;
+	ix = (ix | (ix << 4)) & 0x0f0f;
+	ix = (ix | (ix << 2)) & 0x3333;
+	ix = (ix | (ix << 1)) & 0x5555;
+	iy = (iy | (iy << 4)) & 0x0f0f;
+	iy = (iy | (iy << 2)) & 0x3333;
+	iy = (iy | (iy << 1)) & 0x5555;
+	return (int)(ix | (iy << 1));
+#else
+	return (x & RC_BRICK_MASK) + ((y & RC_BRICK_MASK) << RC_BRICK_SHIFT);
+#endif
+}
+
+/// Returns the lowest span of the column at (x, y), or null if the column is empty.
+template<class Layout>
+inline rcSpanT<Layout>* rcGetColumn(const rcHeightfieldT<Layout>& hf, int x, int y)
+{
+	const rcSpanBrickT<Layout>* brick = hf.bricks[rcBrickIndex(hf, x, y)];
+	return brick ? brick->spans[rcBrickColumnIndex(x, y)] : 0;
+}
+
+/// Allocates an empty brick. It is owned by the caller until stored in rcHeightfieldT::bricks.
+///  @return The brick, or null if out of memory.
+template<class Layout>
+rcSpanBrickT<Layout>* rcAllocBrick();
+
+/// Returns the head pointer of the column at (x, y), allocating its brick if needed.
+///  @return The column head, or null if the brick could not be allocated.
+template<class Layout>
+rcSpanT<Layout>** rcAllocColumn(rcHeightfieldT<Layout>& hf, int x, int y);
+
+/// Returns the index of the group holding the brick at (bx, by).
+template<class Layout>
+inline int rcGroupIndex(const rcHeightfieldT<Layout>& hf, int bx, int by)
+{
+	return (bx >> RC_GROUP_SHIFT) + (by >> RC_GROUP_SHIFT)*hf.groupWidth;
+}
+
+/// Returns the bit of the brick at (bx, by) in its group's brick mask.
+inline unsigned long long rcGroupBrickBit(int bx, int by)
+{
+	return 1ull << ((bx & RC_GROUP_MASK) + ((by & RC_GROUP_MASK) << RC_GROUP_SHIFT));
+}
+
+/// Records a span covering [@p smin, @p smax] in the column at (x, y) in the occupancy pyramid.
+/// Must be called whenever a span is added to a column. The column's brick must exist.
+template<class Layout>
+inline void rcMarkOccupied(rcHeightfieldT<Layout>& hf, int x, int y, int smin, int smax)
+{
+	const int bx = x >> RC_BRICK_SHIFT;
+	const int by = y >> RC_BRICK_SHIFT;
+	rcSpanBrickT<Layout>& brick = *hf.bricks[bx + by*hf.brickWidth];
+	brick.rowMask[y & RC_BRICK_MASK] |= 1u << (x & RC_BRICK_MASK);
+	if (smin < brick.smin) brick.smin = (unsigned short)smin;
+	if (smax > brick.smax) brick.smax = (unsigned short)smax;
+
+	rcBrickGroup& group = hf.groups[rcGroupIndex(hf, bx, by)];
+	group.brickMask |= rcGroupBrickBit(bx, by);
+	if (smin < group.smin) group.smin = (unsigned short)smin;
+	if (smax > group.smax) group.smax = (unsigned short)smax;
+}
+
+/// Marks the columns [@p x0, @p x1] of row @p y as occupied, like #rcMarkOccupied does
+/// column by column. The columns must share a brick, and the brick must exist.
+template<class Layout>
+inline void rcMarkOccupiedRun(rcHeightfieldT<Layout>& hf, int x0, int x1, int y, int smin, int smax)
+{
+	const int bx = x0 >> RC_BRICK_SHIFT;
+	const int by = y >> RC_BRICK_SHIFT;
+	const int count = x1 - x0 + 1;
+	const unsigned int run = count >= RC_BRICK_SIZE ? ~0u : (1u << count) - 1;
+	rcSpanBrickT<Layout>& brick = *hf.bricks[bx + by*hf.brickWidth];
+	brick.rowMask[y & RC_BRICK_MASK] |= run << (x0 & RC_BRICK_MASK);
+	if (smin < brick.smin) brick.smin = (unsigned short)smin;
+	if (smax > brick.smax) brick.smax = (unsigned short)smax;
+
+	rcBrickGroup& group = hf.groups[rcGroupIndex(hf, bx, by)];
+	group.brickMask |= rcGroupBrickBit(bx, by);
+	if (smin < group.smin) group.smin = (unsigned short)smin;
+	if (smax > group.smax) group.smax = (unsigned short)smax;
+}
+
+/// Returns true if any span of the brick may overlap the height range [@p smin, @p smax].
+template<class Layout>
+inline bool rcBrickOverlaps(const rcSpanBrickT<Layout>& brick, int smin, int smax)
+{
+	return (int)brick.smin <= smax && (int)brick.smax >= smin;
+}
+
+/// Returns true if any span of the group may overlap the height range [@p smin, @p smax].
+inline bool rcGroupOverlaps(const rcBrickGroup& group, int smin, int smax)
+{
+	return group.brickMask != 0 && (int)group.smin <= smax && (int)group.smax >= smin;
+}
+
+/// Adds a span to the specified heightfield, merging it with the spans it overlaps.
+///  @param[in,out]	hf				An initialized heightfield.
+///  @param[in]		x				The width index where the span is to be added.
+///  								[Limits: 0 <= value < rcHeightfieldT::width]
+///  @param[in]		y				The height index where the span is to be added.
+///  								[Limits: 0 <= value < rcHeightfieldT::height]
+///  @param[in]		smin			The minimum height of the span. [Limit: < @p smax] [Units: vx]
+///  @param[in]		smax			The maximum height of the span. [Limit: <= Layout::MaxHeight] [Units: vx]
+///  @param[in]		area			The area id of the span. [Limit: <= #RC_WALKABLE_AREA]
+///  @param[in]		flagMergeThr	The merge theshold. [Limit: >= 0] [Units: vx]
+///  @return False if out of memory.
+template<class Layout>
+bool rcAddSpan(rcHeightfieldT<Layout>& hf, const int x, const int y,
+			   const unsigned short smin, const unsigned short smax,
+			   const unsigned char area, const int flagMergeThr);
+
+/// Rasterizes a single triangle into the heightfield, see #rcRasterizeTriangles.
+///  @return False if out of memory, the spans of the triangle may then be incomplete.
+template<class Layout>
+bool rasterizeTri(const float* v0, const float* v1, const float* v2,
+						 const unsigned char area, rcHeightfieldT<Layout>& hf,
 						 const float* bmin, const float* bmax,
 						 const float cs, const float ics, const float ich, 
 						 const int flagMergeThr,
 						 const int rasterizationFlags, /*UE4*/
 						 const int* rasterizationMasks /*UE4*/);
 
+/// Reorders triangles along a Morton (z-curve) order of the cells holding their xz
+/// centroids, so that rasterizing them in that order walks the heightfield block by
+/// block instead of in the order the mesh was authored. Triangles sharing a cell keep
+/// their order. The keys are radix sorted in parallel with #rcParallelFor.
+///  @param[in]		verts	The vertices. [(x, y, z) * nv]
+///  @param[in,out]	tris	The triangle indices, reordered. [(vertA, vertB, vertC) * @p nt]
+///  @param[in,out]	areas	The area id of each triangle, reordered with @p tris. [Size: @p nt]
+///  @param[in]		nt		The number of triangles.
+///  @param[in]		bmin	The minimum bounds of the heightfield. [(x, y, z)]
+///  @param[in]		cs		The xz-plane cell size of the heightfield. [Limit: > 0] [Units: wu]
+///  @param[in]		width	The width of the heightfield. [Units: vx]
+///  @param[in]		height	The height of the heightfield. [Units: vx]
+///  @return False if out of memory, in which case the triangles are left as they were.
+bool rcSortTrianglesMorton(const float* verts, int* tris, unsigned char* areas, const int nt,
+						   const float* bmin, const float cs, const int width, const int height);
+
+/// Rasterizes an indexed triangle mesh into the specified heightfield.
+/// The rasterizer variant for the merge threshold, flags and masks is picked
+/// once for the whole batch, so the per-cell loops carry no feature checks.
+///  @param[in,out]	ctx					The build context to use during the operation.
+///  @param[in]		verts				The vertices. [(x, y, z) * @p nv]
+///  @param[in]		nv					The number of vertices.
+///  @param[in]		tris				The triangle indices. [(vertA, vertB, vertC) * @p nt]
+///  @param[in]		areas				The area id of each triangle. [Limit: <= #RC_WALKABLE_AREA] [Size: @p nt]
+///  @param[in]		nt					The number of triangles.
+///  @param[in,out]	solid				An initialized heightfield.
+///  @param[in]		flagMergeThr		The distance where the walkable flag is favored over the non-walkable flag.
+///  									[Limit: >= 0, negative disables area merging] [Units: vx]
+///  @param[in]		rasterizationFlags	Non-zero to project spans to the bottom of the heightfield. (UE4)
+///  @param[in]		rasterizationMasks	Optional per-column masks for @p rasterizationFlags. [Size: width * height] (UE4)
+///  @return False if out of memory. Rasterization stops at the first triangle that failed,
+///  		the heightfield then holds only part of the mesh.
+template<class Layout>
+bool rcRasterizeTriangles(rcContext* ctx, const float* verts, const int nv,
+						  const int* tris, const unsigned char* areas, const int nt,
+						  rcHeightfieldT<Layout>& solid, const int flagMergeThr = 1,
+						  const int rasterizationFlags = 0, const int* rasterizationMasks = 0);
+
+/// Merges the spans of @p sources into @p dest, with the same overlap and area rules
+/// as rasterization. Each column is merged at once, and rows of bricks are
+/// processed in parallel through #rcParallelFor.
+///  @param[in]		sources			The heightfields to merge. They must share the grid of @p dest
+///  								and must not include @p dest itself. [Size: @p nsources]
+///  @param[in]		nsources		The number of heightfields in @p sources.
+///  @param[in,out]	dest			An initialized heightfield, its own spans are kept.
+///  @param[in]		flagMergeThr	The distance where the walkable flag is favored over the non-walkable flag.
+///  								[Limit: >= 0, negative disables area merging] [Units: vx]
+///  @return False if a grid differs or memory ran out.
+template<class Layout>
+bool rcMergeHeightfields(const rcHeightfieldT<Layout>* const* sources, const int nsources,
+						 rcHeightfieldT<Layout>& dest, const int flagMergeThr);
+
+/// Reference rasterizer. Clips the triangle against the column and returns the span
+/// it covers there. Slow, only meant to check #rasterizeTri against. The column is clipped
+/// in cell units, the way #rasterizeTri bins vertices, and a triangle that only grazes it
+/// within float rounding does not touch it. A point on a grid line counts for the cells on
+/// both sides, except the far corner of the column, which #rasterizeTri only reaches when
+/// its row fill does.
+///  @param[in]		v0, v1, v2	The triangle vertices. [(x, y, z)]
+///  @param[in]		hf			The heightfield, only its bounds and cell sizes are used.
+///  @param[in]		x, y		The column.
+///  @param[out]	smin, smax	The span covered by the triangle. [Units: vx]
+///  @return False if the triangle does not touch the column or misses the height range.
+template<class Layout>
+bool rcRasterizeTriCell(const float* v0, const float* v1, const float* v2, const rcHeightfieldT<Layout>& hf,
+						const int x, const int y, int& smin, int& smax);
+
+/// Counters filled in by #rcCheckRasterizer and #rcFuzzRasterizer.
+/// Zero initialize before the first check, checks accumulate into it.
+struct rcRasterizerCheck
+{
+	int triangles;		///< The number of triangles checked.
+	int cells;			///< The number of columns the reference rasterizer covers.
+	int missing;		///< Columns the reference covers and #rasterizeTri leaves empty.
+	int extra;			///< Columns #rasterizeTri covers and the reference does not touch.
+	int mismatched;		///< Columns whose span bounds differ by more than the tolerance.
+	int maxError;		///< The largest span bound difference. [Units: vx]
+};
+
+/// Rasterizes each triangle on its own with #rasterizeTri and compares every column
+/// it touches against #rcRasterizeTriCell.
+///  @param[in]		verts		The vertices. [(x, y, z) * @p nv]
+///  @param[in]		nv			The number of vertices.
+///  @param[in]		tris		The triangle indices. [(vertA, vertB, vertC) * @p nt]
+///  @param[in]		nt			The number of triangles.
+///  @param[in]		width, height, bmin, bmax, cs, ch	The heightfield to check in, see #rcCreateHeightfield.
+///  @param[in]		tolerance	The span bound difference still accepted. [Units: vx]
+///  @param[in,out]	result		The counters to add to.
+///  @return False if the heightfield could not be allocated.
+template<class Layout>
+bool rcCheckRasterizer(const float* verts, const int nv, const int* tris, const int nt,
+					   const int width, const int height, const float* bmin, const float* bmax,
+					   const float cs, const float ch, const int tolerance, rcRasterizerCheck& result);
+
+/// Runs #rcCheckRasterizer on random triangles, with flat, vertical, repeated vertex,
+/// grid aligned, sliver and out of bounds cases mixed in.
+///  @param[in]		seed		The random seed, a failing seed replays the same triangles.
+///  @param[in]		nt			The number of triangles.
+///  @param[in]		tolerance	The span bound difference still accepted. [Units: vx]
+///  @param[in,out]	result		The counters to add to.
+template<class Layout>
+bool rcFuzzRasterizer(const unsigned int seed, const int nt, const int tolerance, rcRasterizerCheck& result);
+
+/// Gets the standard width (x-axis) offset for the specified direction.
+///  @param[in]		dir		The direction. [Limits: 0 <= value < 4]
+///  @return The width offset to apply to the current cell position to move
+/// 	in the direction.
+inline int rcGetDirOffsetX(int dir)
+{
+	static const int offset[4] = { -1, 0, 1, 0, };
+	return offset[dir&0x03];
+}
+
+/// Gets the standard height (z-axis) offset for the specified direction.
+///  @param[in]		dir		The direction. [Limits: 0 <= value < 4]
+///  @return The height offset to apply to the current cell position to move
+/// 	in the direction.
+inline int rcGetDirOffsetY(int dir)
+{
+	static const int offset[4] = { 0, 1, 0, -1 };
+	return offset[dir&0x03];
+}
+
+/// Gets the span connected to a span of a column heightfield in the specified direction.
+///  @param[in]		chf		A column heightfield with connections.
+///  @param[in]		x		The x-position of the column of the span.
+///  @param[in]		y		The y-position of the column of the span.
+///  @param[in]		i		The index of the span.
+///  @param[in]		dir		The direction. [Limits: 0 <= value < 4]
+///  @return The index of the connected span, or -1 if there is none.
+inline int rcGetColumnNeighbour(const rcColumnHeightfield& chf, int x, int y, unsigned int i, int dir)
+{
+	const unsigned short con = chf.cons[i*4 + dir];
+	if (con == RC_NOT_CONNECTED)
+		return -1;
+	const int nx = x + rcGetDirOffsetX(dir);
+	const int ny = y + rcGetDirOffsetY(dir);
+	return (int)(chf.cells[nx + ny*chf.width] + con);
+}
+
+/// Marks non-walkable spans as walkable if their maximum is within @p walkableClimb of a walkable neighbor. 
+/// Rows of bricks are processed in parallel through #rcParallelFor.
+///  @param[in]		walkableClimb	Maximum ledge height that is considered to still be traversable. 
+///  								[Limit: >=0] [Units: vx]
+///  @param[in,out]	solid			A fully built heightfield.  (All spans have been added.)
+template<class Layout>
+void rcFilterLowHangingWalkableObstacles(const int walkableClimb, rcHeightfieldT<Layout>& solid);
+
+/// Marks spans that are ledges as not-walkable.
+/// Rows of bricks are processed in parallel through #rcParallelFor. Each band reads
+/// the row above and below it as a halo, so neighbouring bands never run at once.
+///  @param[in]		walkableHeight	Minimum floor to 'ceiling' height that will still allow the floor area to 
+///  								be considered walkable. [Limit: >= 3] [Units: vx]
+///  @param[in]		walkableClimb	Maximum ledge height that is considered to still be traversable. 
+///  								[Limit: >=0] [Units: vx]
+///  @param[in,out]	solid			A fully built heightfield.  (All spans have been added.)
+template<class Layout>
+void rcFilterLedgeSpans(const int walkableHeight, const int walkableClimb, rcHeightfieldT<Layout>& solid);
+
+/// Marks walkable spans as not walkable if the clearence above the span is less than the specified height.
+/// Rows of bricks are processed in parallel through #rcParallelFor.
+///  @param[in]		walkableHeight	Minimum floor to 'ceiling' height that will still allow the floor area to 
+///  								be considered walkable. [Limit: >= 3] [Units: vx]
+///  @param[in,out]	solid			A fully built heightfield.  (All spans have been added.)
+template<class Layout>
+void rcFilterWalkableLowHeightSpans(const int walkableHeight, rcHeightfieldT<Layout>& solid);
+
+/// Finds the walkable span top closest in height to @p pos, in the column containing @p pos.
+///  @param[in]		hf			The heightfield.
+///  @param[in]		pos			The query position. [(x, y, z)]
+///  @param[out]	top			The world height of the span top.
+///  @param[out]	clearance	The open height above the span top, up to the next span of the column.
+///  							[FLT_MAX for the highest span of the column]
+///  @return True if the column holds a walkable span.
+template<class Layout>
+bool rcQueryWalkableHeight(const rcHeightfieldT<Layout>& hf, const float* pos, float& top, float& clearance);
+
+/// Casts a ray segment through the spans of the heightfield.
+/// Walks bricks first and only steps through the columns of bricks whose
+/// height range overlaps the ray.
+///  @param[in]		hf			The heightfield.
+///  @param[in]		start		The start of the ray segment. [(x, y, z)]
+///  @param[in]		end			The end of the ray segment. [(x, y, z)]
+///  @param[out]	hitT		The parametric distance of the hit along the segment. [Limits: 0 <= value <= 1]
+///  @return True if the segment hits a span.
+template<class Layout>
+bool rcRaycastHeightfield(const rcHeightfieldT<Layout>& hf, const float* start, const float* end, float& hitT);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,265 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+#include "Recast.h"
+#include "RecastAlloc.h"
+#include "RecastAssert.h"
+#include "RecastMath.h"
+#include "RecastParallel.h"
+#include <string.h>
+
+/// The distance passes run over square blocks of cells, a wave of blocks at a time.
+static const int RC_DISTANCE_BLOCK = RC_BRICK_SIZE;
+
+/// Distance of a span that is not yet known to be near a boundary.
+static const unsigned short RC_DISTANCE_FAR = 0xffff;
+
+/// The distance passes run one task item per block of a wave, or per row of cells.
+struct rcDistanceTask
+{
+	const rcColumnHeightfield* chf;
+	unsigned short* dist;
+	bool sameArea;		///< Boundaries are neighbours of another area, not only unwalkable ones.
+	int blocksX;
+	int blocksY;
+	int wave;			///< The wave of blocks being processed.
+	int firstBlockY;	///< Block row of the first task item of the wave.
+	bool backward;		///< Sweeps the grid mirrored, from the far corner.
+};
+
+/// Sets the boundary spans of the rows [begin, end) to 0 and all others to #RC_DISTANCE_FAR.
+static void markBoundaries(void* userData, int begin, int end)
+{
+	const rcDistanceTask& task = *(const rcDistanceTask*)userData;
+	const rcColumnHeightfield& chf = *task.chf;
+	for (int y = begin; y < end; ++y)
+	{
+		for (int x = 0; x < chf.width; ++x)
+		{
+			const int c = x + y*chf.width;
+			for (unsigned int i = chf.cells[c]; i < chf.cells[c + 1]; ++i)
+			{
+				const unsigned char area = chf.areas[i];
+				int nc = 0;
+				if (area != RC_NULL_AREA)
+				{
+					for (int dir = 0; dir < 4; ++dir)
+					{
+						const int ni = rcGetColumnNeighbour(chf, x, y, i, dir);
+						if (ni >= 0 && chf.areas[ni] != RC_NULL_AREA && (!task.sameArea || chf.areas[ni] == area))
+							nc++;
+					}
+				}
+				task.dist[i] = nc == 4 ? RC_DISTANCE_FAR : 0;
+			}
+		}
+	}
+}
+
+/// Lowers the distance of span @p i at (@p x, @p y) through its neighbour in @p dir,
+/// and through that neighbour's neighbour in @p diagDir.
+static inline void relaxSpan(const rcColumnHeightfield& chf, unsigned short* dist, int x, int y, unsigned int i,
+							 int dir, int diagDir)
+{
+	const int ai = rcGetColumnNeighbour(chf, x, y, i, dir);
+	if (ai < 0)
+		return;
+	int d = rcMin((int)dist[i], dist[ai] + 2);
+	const int ax = x + rcGetDirOffsetX(dir);
+	const int ay = y + rcGetDirOffsetY(dir);
+	const int bi = rcGetColumnNeighbour(chf, ax, ay, (unsigned int)ai, diagDir);
+	if (bi >= 0)
+		d = rcMin(d, dist[bi] + 3);
+	dist[i] = (unsigned short)d;
+}
+
+/// Runs the chamfer pass over the blocks of one wave.
+static void sweepDistanceBlocks(void* userData, int begin, int end)
+{
+	const rcDistanceTask& task = *(const rcDistanceTask*)userData;
+	const rcColumnHeightfield& chf = *task.chf;
+	for (int item = begin; item < end; ++item)
+	{
+		const int by = task.firstBlockY + item;
+		const int bx = task.wave - 2*by;
+		const int y0 = by*RC_DISTANCE_BLOCK;
+		const int y1 = rcMin(y0 + RC_DISTANCE_BLOCK, chf.height);
+		for (int sy = y0; sy < y1; ++sy)
+		{
+			// Every row of a block starts one cell left of the row before.
+			const int skew = sy - y0;
+			const int x0 = rcMax(bx*RC_DISTANCE_BLOCK - skew, 0);
+			const int x1 = rcMin((bx + 1)*RC_DISTANCE_BLOCK - skew, chf.width);
+			for (int sx = x0; sx < x1; ++sx)
+			{
+				if (!task.backward)
+				{
+					// From (-1,0) and (-1,-1), then from (0,-1) and (1,-1).
+					const int c = sx + sy*chf.width;
+					for (unsigned int i = chf.cells[c]; i < chf.cells[c + 1]; ++i)
+					{
+						relaxSpan(chf, task.dist, sx, sy, i, 0, 3);
+						relaxSpan(chf, task.dist, sx, sy, i, 3, 2);
+					}
+				}
+				else
+				{
+					// The same sweep mirrored: from (1,0) and (1,1), then from (0,1) and (-1,1).
+					const int x = chf.width - 1 - sx;
+					const int y = chf.height - 1 - sy;
+					const int c = x + y*chf.width;
+					for (unsigned int i = chf.cells[c]; i < chf.cells[c + 1]; ++i)
+					{
+						relaxSpan(chf, task.dist, x, y, i, 2, 1);
+						relaxSpan(chf, task.dist, x, y, i, 1, 0);
+					}
+				}
+			}
+		}
+	}
+}
+
+/// Computes the chamfer distance of every span of @p chf to the nearest boundary.
+///
+/// Each pass reads the cell before it in its row, and the cells from one before
+/// to one after it in the row before. The rows are split into bands, and the bands
+/// into blocks whose rows are skewed one cell left per row, so a block only waits
+/// for the block before it in its band and for the two blocks above it, the second
+/// of which is one block to the right. Giving the block at (bx, by) the wave
+/// bx + 2*by orders all of them before it, and the blocks of one wave run in
+/// parallel. The result matches a serial sweep.
+static void calculateDistanceField(const rcColumnHeightfield& chf, unsigned short* dist, bool sameArea)
+{
+	rcDistanceTask task;
+	task.chf = &chf;
+	task.dist = dist;
+	task.sameArea = sameArea;
+	// One more block column covers the cells the skew moves past the last block.
+	task.blocksX = (chf.width + RC_DISTANCE_BLOCK - 1) / RC_DISTANCE_BLOCK + 1;
+	task.blocksY = (chf.height + RC_DISTANCE_BLOCK - 1) / RC_DISTANCE_BLOCK;
+	task.wave = 0;
+	task.firstBlockY = 0;
+	task.backward = false;
+
+	rcParallelFor(chf.height, RC_BRICK_SIZE, markBoundaries, &task);
+
+	const int nwaves = task.blocksX + 2*(task.blocksY - 1);
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		task.backward = pass == 1;
+		for (task.wave = 0; task.wave < nwaves; ++task.wave)
+		{
+			// The block rows whose block column of this wave is inside the grid.
+			task.firstBlockY = rcMax(0, (task.wave - task.blocksX + 2) / 2);
+			const int lastBlockY = rcMin(task.blocksY - 1, task.wave / 2);
+			if (lastBlockY >= task.firstBlockY)
+				rcParallelFor(lastBlockY - task.firstBlockY + 1, 1, sweepDistanceBlocks, &task);
+		}
+	}
+}
+
+/// Eroding runs one task item per row of cells.
+struct rcErodeTask
+{
+	rcColumnHeightfield* chf;
+	const unsigned short* dist;
+	int threshold;
+};
+
+static void erodeRows(void* userData, int begin, int end)
+{
+	const rcErodeTask& task = *(const rcErodeTask*)userData;
+	rcColumnHeightfield& chf = *task.chf;
+	const unsigned int first = chf.cells[begin*chf.width];
+	const unsigned int last = chf.cells[end*chf.width];
+	for (unsigned int i = first; i < last; ++i)
+	{
+		if (task.dist[i] < task.threshold)
+			chf.areas[i] = RC_NULL_AREA;
+	}
+}
+
+/// @par
+///
+/// Basically, any spans that are closer to a boundary or obstruction than the specified radius 
+/// are marked as unwalkable.
+///
+/// The distance to the boundaries is a chamfer distance, swept in parallel as in
+/// #rcBuildDistanceField.
+///
+/// @see rcBuildColumnConnections, rcBuildDistanceField
+bool rcErodeWalkableArea(int radius, rcColumnHeightfield& chf)
+{
+	rcAssert(chf.cons);
+
+	rcScopedDelete<unsigned short> dist(chf.spanCount + 1);
+	if (!dist)
+		return false;
+
+	calculateDistanceField(chf, dist, false);
+
+	rcErodeTask task = { &chf, dist, radius*2 };
+	rcParallelFor(chf.height, RC_BRICK_SIZE, erodeRows, &task);
+	return true;
+}
+
+/// @par
+///
+/// The distances are chamfer distances of 2 for a step along an axis and 3 for a
+/// diagonal step, so half the distance approximates the number of cells. Steps
+/// follow the span connections, so a span's distance is measured over the surface
+/// an agent walks on. The forward and backward passes sweep blocks of the grid in
+/// diagonal waves, with the blocks of each wave processed in parallel through
+/// #rcParallelFor.
+///
+/// @see rcBuildColumnConnections, rcErodeWalkableArea
+bool rcBuildDistanceField(rcColumnHeightfield& chf)
+{
+	rcAssert(chf.cons);
+
+	rcFree(chf.dist);
+	chf.maxDistance = 0;
+	chf.dist = (unsigned short*)rcAlloc(sizeof(unsigned short)*(chf.spanCount + 1), RC_ALLOC_PERM);
+	if (!chf.dist)
+		return false;
+
+	calculateDistanceField(chf, chf.dist, true);
+
+	unsigned short maxDist = 0;
+	for (int i = 0; i < chf.spanCount; ++i)
+		maxDist = rcMax(maxDist, chf.dist[i]);
+	chf.maxDistance = maxDist;
+	return true;
+}
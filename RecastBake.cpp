@@ -0,0 +1,630 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+// Headless batch baker. Splits the bounds of a mesh into tiles with overlap
+// borders, rasterizes every tile in its own worker process and writes each
+// tile to its own file, plus a manifest describing how to stitch them.
+//
+//   RecastBake <mesh.obj> <outdir> [options]
+//
+// The coordinator parses the mesh once and bins its triangles per tile. It then
+// starts the same executable with --worker for every tile, handing it a file
+// with only the triangles of that tile in place of the mesh.
+//
+// With --export every tile is also written as a compressed export, and with
+// --export-base those exports are deltas against the exports of an earlier bake.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Recast.h"
+#include "RecastMath.h"
+#include "RecastExport.h"
+#include "RecastMeshLoaderObj.h"
+#include "RecastParallel.h"
+#include "RecastTile.h"
+
+struct BakeOptions
+{
+	std::string mesh;
+	std::string outDir;
+	float cs = 0.3f;
+	float ch = 0.2f;
+	int tileSize = 256;			///< Tile size without the border. [Units: vx]
+	int border = 8;				///< Overlap cells on each side of a tile. [Units: vx]
+	int workers = 0;			///< Worker processes, 0 bakes every tile in this process.
+	int flagMergeThr = 1;
+	bool filters = false;
+	float walkableHeight = 2.0f;
+	float walkableClimb = 0.9f;
+	bool exportTiles = false;	///< Also write each tile as a compressed export.
+	std::string exportBase;		///< Directory of an earlier bake to write the exports as deltas against.
+
+	// Set by the coordinator on the worker command line.
+	bool worker = false;
+	int tx = 0;
+	int ty = 0;
+	bool hasBounds = false;
+	float bmin[3];
+	float bmax[3];
+};
+
+/// The tile grid shared by the coordinator and the workers.
+struct BakeGrid
+{
+	float bmin[3];
+	float bmax[3];
+	int width;
+	int height;
+	int tilesX;
+	int tilesY;
+};
+
+/// Tile size of the index of the tile exports, small so deltas only keep what changed. [Units: vx]
+static const int BAKE_EXPORT_TILE = 64;
+
+/// Prints the warnings and errors of the build steps.
+class BakeContext : public rcContext
+{
+protected:
+	virtual void doLog(const rcLogCategory category, const char* msg, const int /*len*/)
+	{
+		if (category != RC_LOG_PROGRESS)
+			fprintf(stderr, "RecastBake: %s\n", msg);
+	}
+};
+
+static void printUsage()
+{
+	printf("usage: RecastBake <mesh.obj> <outdir> [options]\n"
+		"  --cs <size>             cell size (0.3)\n"
+		"  --ch <size>             cell height (0.2)\n"
+		"  --tile <cells>          tile size without the border (256)\n"
+		"  --border <cells>        overlap cells on each side of a tile (8)\n"
+		"  --workers <count>       worker processes, 0 bakes in process (hardware threads)\n"
+		"  --merge <voxels>        flagMergeThr of the rasterizer (1)\n"
+		"  --filters               run the walkable filters on every tile\n"
+		"  --walkable-height <h>   walkable height of the filters (2)\n"
+		"  --walkable-climb <h>    walkable climb of the filters (0.9)\n"
+		"  --export                also write every tile as a compressed export\n"
+		"  --export-base <dir>     write the exports as deltas against the exports in an earlier bake\n");
+}
+
+static bool parseOptions(int argc, char** argv, BakeOptions& opts)
+{
+	opts.workers = (int)std::thread::hardware_concurrency();
+
+	std::vector<const char*> positional;
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if (strcmp(arg, "--cs") == 0 && hasValue)
+			opts.cs = (float)atof(argv[++i]);
+		else if (strcmp(arg, "--ch") == 0 && hasValue)
+			opts.ch = (float)atof(argv[++i]);
+		else if (strcmp(arg, "--tile") == 0 && hasValue)
+			opts.tileSize = atoi(argv[++i]);
+		else if (strcmp(arg, "--border") == 0 && hasValue)
+			opts.border = atoi(argv[++i]);
+		else if (strcmp(arg, "--workers") == 0 && hasValue)
+			opts.workers = atoi(argv[++i]);
+		else if (strcmp(arg, "--merge") == 0 && hasValue)
+			opts.flagMergeThr = atoi(argv[++i]);
+		else if (strcmp(arg, "--filters") == 0)
+			opts.filters = true;
+		else if (strcmp(arg, "--walkable-height") == 0 && hasValue)
+			opts.walkableHeight = (float)atof(argv[++i]);
+		else if (strcmp(arg, "--walkable-climb") == 0 && hasValue)
+			opts.walkableClimb = (float)atof(argv[++i]);
+		else if (strcmp(arg, "--export") == 0)
+			opts.exportTiles = true;
+		else if (strcmp(arg, "--export-base") == 0 && hasValue)
+		{
+			opts.exportTiles = true;
+			opts.exportBase = argv[++i];
+		}
+		else if (strcmp(arg, "--worker") == 0 && i + 2 < argc)
+		{
+			opts.worker = true;
+			opts.tx = atoi(argv[++i]);
+			opts.ty = atoi(argv[++i]);
+		}
+		else if (strcmp(arg, "--bounds") == 0 && i + 6 < argc)
+		{
+			opts.hasBounds = true;
+			for (int j = 0; j < 3; ++j)
+				opts.bmin[j] = (float)atof(argv[++i]);
+			for (int j = 0; j < 3; ++j)
+				opts.bmax[j] = (float)atof(argv[++i]);
+		}
+		else if (arg[0] == '-')
+		{
+			fprintf(stderr, "RecastBake: unknown option %s\n", arg);
+			return false;
+		}
+		else
+			positional.push_back(arg);
+	}
+
+	if (positional.size() != 2 || opts.cs <= 0.0f || opts.ch <= 0.0f || opts.tileSize <= 0 || opts.border < 0)
+		return false;
+	opts.mesh = positional[0];
+	opts.outDir = positional[1];
+	return true;
+}
+
+static void initGrid(const BakeOptions& opts, const float* bmin, const float* bmax, BakeGrid& grid)
+{
+	rcVcopy(grid.bmin, bmin);
+	rcVcopy(grid.bmax, bmax);
+	rcCalcGridSize(bmin, bmax, opts.cs, &grid.width, &grid.height);
+	grid.width = rcMax(grid.width, 1);
+	grid.height = rcMax(grid.height, 1);
+	grid.tilesX = (grid.width + opts.tileSize - 1) / opts.tileSize;
+	grid.tilesY = (grid.height + opts.tileSize - 1) / opts.tileSize;
+}
+
+static const int BAKE_TRIS_MAGIC = 'R'<<24 | 'C'<<16 | 'T'<<8 | 'T';
+
+static std::string tileFileName(int tx, int ty)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "tile_%d_%d.rch", tx, ty);
+	return name;
+}
+
+static std::string exportFileName(int tx, int ty)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "tile_%d_%d.rche", tx, ty);
+	return name;
+}
+
+static std::string trisFileName(int tx, int ty)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "tile_%d_%d.tris", tx, ty);
+	return name;
+}
+
+/// The window of a tile in the full grid, including the border cut at the grid edges.
+static void tileWindow(const BakeOptions& opts, const BakeGrid& grid, int tx, int ty, int& x0, int& y0, int& x1, int& y1)
+{
+	x0 = rcMax(tx * opts.tileSize - opts.border, 0);
+	y0 = rcMax(ty * opts.tileSize - opts.border, 0);
+	x1 = rcMin((tx + 1) * opts.tileSize + opts.border, grid.width);
+	y1 = rcMin((ty + 1) * opts.tileSize + opts.border, grid.height);
+}
+
+/// Bins the triangles of the mesh into every tile whose window they touch, as vertex
+/// index triples. A triangle near a tile edge lands in each tile it overlaps.
+static void binTriangles(const BakeOptions& opts, const BakeGrid& grid, const float* verts, const int* tris, const int ntris,
+						 std::vector<std::vector<int> >& tileTris)
+{
+	tileTris.clear();
+	tileTris.resize(grid.tilesX * grid.tilesY);
+
+	const float ics = 1.0f / opts.cs;
+	const float tileCells = (float)opts.tileSize;
+	for (int i = 0; i < ntris; ++i)
+	{
+		const float* v0 = &verts[tris[i*3+0]*3];
+		const float* v1 = &verts[tris[i*3+1]*3];
+		const float* v2 = &verts[tris[i*3+2]*3];
+		const float tmin[2] = { rcMin(v0[0], rcMin(v1[0], v2[0])), rcMin(v0[2], rcMin(v1[2], v2[2])) };
+		const float tmax[2] = { rcMax(v0[0], rcMax(v1[0], v2[0])), rcMax(v0[2], rcMax(v1[2], v2[2])) };
+
+		// Candidate tiles from the cell bounds, widened by one so float rounding cannot
+		// drop a tile; the exact test below matches the window bounds.
+		const int tx0 = rcMax((int)floorf(((tmin[0] - grid.bmin[0]) * ics - opts.border) / tileCells) - 1, 0);
+		const int ty0 = rcMax((int)floorf(((tmin[1] - grid.bmin[2]) * ics - opts.border) / tileCells) - 1, 0);
+		const int tx1 = rcMin((int)floorf(((tmax[0] - grid.bmin[0]) * ics + opts.border) / tileCells) + 1, grid.tilesX - 1);
+		const int ty1 = rcMin((int)floorf(((tmax[1] - grid.bmin[2]) * ics + opts.border) / tileCells) + 1, grid.tilesY - 1);
+
+		for (int ty = ty0; ty <= ty1; ++ty)
+		{
+			for (int tx = tx0; tx <= tx1; ++tx)
+			{
+				int x0, y0, x1, y1;
+				tileWindow(opts, grid, tx, ty, x0, y0, x1, y1);
+				if (tmax[0] < grid.bmin[0] + x0 * opts.cs || tmin[0] > grid.bmin[0] + x1 * opts.cs ||
+					tmax[1] < grid.bmin[2] + y0 * opts.cs || tmin[1] > grid.bmin[2] + y1 * opts.cs)
+					continue;
+				std::vector<int>& bin = tileTris[tx + ty * grid.tilesX];
+				bin.push_back(tris[i*3+0]);
+				bin.push_back(tris[i*3+1]);
+				bin.push_back(tris[i*3+2]);
+			}
+		}
+	}
+}
+
+/// Writes the triangles of a tile for its worker, with only the vertices they use.
+/// The file is a magic, the vertex and triangle counts, the vertices and the triangles.
+static bool writeTileTris(const char* path, const float* verts, const std::vector<int>& tileTris)
+{
+	std::vector<int> remap;
+	std::vector<float> tileVerts;
+	std::vector<int> tris(tileTris.size());
+	for (size_t i = 0; i < tileTris.size(); ++i)
+	{
+		const int v = tileTris[i];
+		if (v >= (int)remap.size())
+			remap.resize(v + 1, -1);
+		if (remap[v] < 0)
+		{
+			remap[v] = (int)tileVerts.size() / 3;
+			tileVerts.insert(tileVerts.end(), &verts[v*3], &verts[v*3] + 3);
+		}
+		tris[i] = remap[v];
+	}
+
+	FILE* fp = fopen(path, "wb");
+	if (!fp)
+		return false;
+	const int header[3] = { BAKE_TRIS_MAGIC, (int)tileVerts.size() / 3, (int)tris.size() / 3 };
+	bool ok = fwrite(header, sizeof(header), 1, fp) == 1;
+	if (ok && !tileVerts.empty())
+		ok = fwrite(&tileVerts[0], sizeof(float), tileVerts.size(), fp) == tileVerts.size();
+	if (ok && !tris.empty())
+		ok = fwrite(&tris[0], sizeof(int), tris.size(), fp) == tris.size();
+	return fclose(fp) == 0 && ok;
+}
+
+/// Reads the triangles a coordinator wrote with #writeTileTris.
+static bool readTileTris(const char* path, std::vector<float>& verts, std::vector<int>& tris)
+{
+	FILE* fp = fopen(path, "rb");
+	if (!fp)
+		return false;
+	int header[3];
+	bool ok = fread(header, sizeof(header), 1, fp) == 1 && header[0] == BAKE_TRIS_MAGIC && header[1] >= 0 && header[2] >= 0;
+	if (ok)
+	{
+		verts.resize((size_t)header[1] * 3);
+		tris.resize((size_t)header[2] * 3);
+		ok = (verts.empty() || fread(&verts[0], sizeof(float), verts.size(), fp) == verts.size()) &&
+			 (tris.empty() || fread(&tris[0], sizeof(int), tris.size(), fp) == tris.size());
+	}
+	fclose(fp);
+	if (!ok)
+		return false;
+
+	for (size_t i = 0; i < tris.size(); ++i)
+	{
+		if (tris[i] < 0 || tris[i] >= header[1])
+			return false;
+	}
+	return true;
+}
+
+static bool readFile(const std::string& path, std::vector<unsigned char>& bytes)
+{
+	FILE* fp = fopen(path.c_str(), "rb");
+	if (!fp)
+		return false;
+	fseek(fp, 0, SEEK_END);
+	const long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	bytes.resize(size > 0 ? (size_t)size : 0);
+	const bool ok = size >= 0 && (bytes.empty() || fread(&bytes[0], 1, bytes.size(), fp) == bytes.size());
+	fclose(fp);
+	return ok;
+}
+
+/// Writes the window of the tile as a compressed export, as a delta if the base bake has
+/// an export of the same tile. A base tile baked with other settings is not used.
+template<class Layout>
+static bool exportTile(const BakeOptions& opts, const rcHeightfieldT<Layout>& hf, int x0, int y0, int width, int height,
+					   int tx, int ty)
+{
+	std::vector<unsigned char> base;
+	rcExportHeader baseHeader;
+	if (!opts.exportBase.empty() && readFile(opts.exportBase + "/" + exportFileName(tx, ty), base) &&
+		!(rcReadExportHeader(base.empty() ? 0 : &base[0], (int)base.size(), baseHeader) && !baseHeader.isDelta &&
+		  baseHeader.width == width && baseHeader.height == height && baseHeader.tileSize == BAKE_EXPORT_TILE))
+	{
+		fprintf(stderr, "RecastBake: ignoring the base export of tile %d %d, it does not match this bake\n", tx, ty);
+		base.clear();
+	}
+
+	rcExportBuffer exported;
+	if (!rcEncodeHeightfield(hf, x0, y0, width, height, BAKE_EXPORT_TILE,
+							 base.empty() ? 0 : &base[0], (int)base.size(), exported))
+		return false;
+
+	const std::string path = opts.outDir + "/" + exportFileName(tx, ty);
+	FILE* fp = fopen(path.c_str(), "wb");
+	bool ok = fp != 0;
+	if (fp)
+	{
+		ok = fwrite(exported.data, 1, exported.size, fp) == (size_t)exported.size;
+		ok = fclose(fp) == 0 && ok;
+	}
+	rcFreeExportBuffer(exported);
+	return ok;
+}
+
+/// Rasterizes the triangles binned to the tile and its border, then writes the tile.
+template<class Layout>
+static bool bakeTile(const BakeOptions& opts, const BakeGrid& grid, const float* verts, const int nverts,
+					 const std::vector<int>& tileTris, int tx, int ty)
+{
+	int x0, y0, x1, y1;
+	tileWindow(opts, grid, tx, ty, x0, y0, x1, y1);
+
+	const int ntris = (int)tileTris.size() / 3;
+	std::vector<unsigned char> areas(ntris, RC_WALKABLE_AREA);
+
+	// Rasterize in the frame of the full grid, so the cells of the window come out
+	// exactly as in a single bake. Columns outside the triangles cost no memory.
+	rcHeightfieldT<Layout>* solid = rcAllocHeightfield<Layout>();
+	if (!solid || !rcCreateHeightfield(*solid, grid.width, grid.height, grid.bmin, grid.bmax, opts.cs, opts.ch))
+	{
+		rcFreeHeightField(solid);
+		return false;
+	}
+
+	// A tile missing part of its triangles must not be written as a valid one.
+	BakeContext ctx;
+	if (ntris && !rcRasterizeTriangles(&ctx, verts, nverts, &tileTris[0], &areas[0], ntris, *solid, opts.flagMergeThr))
+	{
+		fprintf(stderr, "RecastBake: out of memory rasterizing tile %d %d\n", tx, ty);
+		rcFreeHeightField(solid);
+		return false;
+	}
+
+	if (opts.filters)
+	{
+		const int walkableHeight = (int)ceilf(opts.walkableHeight / opts.ch);
+		const int walkableClimb = (int)floorf(opts.walkableClimb / opts.ch);
+		rcFilterLowHangingWalkableObstacles(walkableClimb, *solid);
+		rcFilterLedgeSpans(walkableHeight, walkableClimb, *solid);
+		rcFilterWalkableLowHeightSpans(walkableHeight, *solid);
+	}
+
+	const std::string path = opts.outDir + "/" + tileFileName(tx, ty);
+	bool ok = rcWriteTile(path.c_str(), *solid, x0, y0, x1 - x0, y1 - y0, tx, ty, opts.border);
+	if (ok && opts.exportTiles)
+		ok = exportTile(opts, *solid, x0, y0, x1 - x0, y1 - y0, tx, ty);
+	rcFreeHeightField(solid);
+	return ok;
+}
+
+static bool bakeTile(const BakeOptions& opts, const BakeGrid& grid, const float* verts, const int nverts,
+					 const std::vector<int>& tileTris, int tx, int ty)
+{
+	// Same choice as the SOP: the compact layout unless the bounds are too tall for it.
+	const int spanHeight = (int)ceilf((grid.bmax[1] - grid.bmin[1]) / opts.ch);
+	if (spanHeight <= rcSpanLayoutCompact::MaxHeight)
+		return bakeTile<rcSpanLayoutCompact>(opts, grid, verts, nverts, tileTris, tx, ty);
+	return bakeTile<rcSpanLayoutTall>(opts, grid, verts, nverts, tileTris, tx, ty);
+}
+
+static std::string quote(const std::string& s)
+{
+	return "\"" + s + "\"";
+}
+
+static std::string workerCommand(const char* exe, const BakeOptions& opts, const BakeGrid& grid,
+								 const std::string& trisPath, int tx, int ty)
+{
+	char args[512];
+	snprintf(args, sizeof(args),
+		" --worker %d %d --cs %.9g --ch %.9g --tile %d --border %d --merge %d"
+		" --walkable-height %.9g --walkable-climb %.9g --bounds %.9g %.9g %.9g %.9g %.9g %.9g%s",
+		tx, ty, opts.cs, opts.ch, opts.tileSize, opts.border, opts.flagMergeThr,
+		opts.walkableHeight, opts.walkableClimb,
+		grid.bmin[0], grid.bmin[1], grid.bmin[2], grid.bmax[0], grid.bmax[1], grid.bmax[2],
+		opts.filters ? " --filters" : "");
+	std::string cmd = quote(exe) + " " + quote(trisPath) + " " + quote(opts.outDir) + args;
+	if (!opts.exportBase.empty())
+		cmd += " --export-base " + quote(opts.exportBase);
+	else if (opts.exportTiles)
+		cmd += " --export";
+#ifdef _WIN32
+	// cmd.exe strips the outer quotes of the whole command line.
+	cmd = "\"" + cmd + "\"";
+#endif
+	return cmd;
+}
+
+static bool writeManifest(const BakeOptions& opts, const BakeGrid& grid, const std::vector<char>& tileOk)
+{
+	const std::string path = opts.outDir + "/manifest.json";
+	FILE* fp = fopen(path.c_str(), "w");
+	if (!fp)
+		return false;
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"version\": %d,\n", RC_TILE_VERSION);
+	fprintf(fp, "  \"cs\": %.9g,\n  \"ch\": %.9g,\n", opts.cs, opts.ch);
+	fprintf(fp, "  \"bmin\": [%.9g, %.9g, %.9g],\n", grid.bmin[0], grid.bmin[1], grid.bmin[2]);
+	fprintf(fp, "  \"bmax\": [%.9g, %.9g, %.9g],\n", grid.bmax[0], grid.bmax[1], grid.bmax[2]);
+	fprintf(fp, "  \"width\": %d,\n  \"height\": %d,\n", grid.width, grid.height);
+	fprintf(fp, "  \"tileSize\": %d,\n  \"border\": %d,\n", opts.tileSize, opts.border);
+	fprintf(fp, "  \"tilesX\": %d,\n  \"tilesY\": %d,\n", grid.tilesX, grid.tilesY);
+	if (opts.exportTiles)
+		fprintf(fp, "  \"exportTileSize\": %d,\n", BAKE_EXPORT_TILE);
+	fprintf(fp, "  \"tiles\": [\n");
+	for (int ty = 0; ty < grid.tilesY; ++ty)
+	{
+		for (int tx = 0; tx < grid.tilesX; ++tx)
+		{
+			const int i = tx + ty * grid.tilesX;
+			// The core cells of the tile start at (x, y) in the full grid.
+			fprintf(fp, "    { \"x\": %d, \"y\": %d, \"coreX\": %d, \"coreY\": %d, \"file\": \"%s\", ",
+				tx, ty, tx * opts.tileSize, ty * opts.tileSize, tileFileName(tx, ty).c_str());
+			if (opts.exportTiles)
+				fprintf(fp, "\"export\": \"%s\", ", exportFileName(tx, ty).c_str());
+			fprintf(fp, "\"ok\": %s }%s\n", tileOk[i] ? "true" : "false", i + 1 < grid.tilesX * grid.tilesY ? "," : "");
+		}
+	}
+	fprintf(fp, "  ]\n}\n");
+
+	return fclose(fp) == 0;
+}
+
+int main(int argc, char** argv)
+{
+	rcParallelSetCustom(rcParallelForThreads);
+
+	BakeOptions opts;
+	if (!parseOptions(argc, argv, opts))
+	{
+		printUsage();
+		return 1;
+	}
+
+	// A worker only reads the triangles the coordinator binned to its tile.
+	if (opts.worker)
+	{
+		if (!opts.hasBounds)
+		{
+			fprintf(stderr, "RecastBake: --worker needs --bounds\n");
+			return 1;
+		}
+		std::vector<float> verts;
+		std::vector<int> tris;
+		if (!readTileTris(opts.mesh.c_str(), verts, tris))
+		{
+			fprintf(stderr, "RecastBake: could not read %s\n", opts.mesh.c_str());
+			return 1;
+		}
+		BakeGrid grid;
+		initGrid(opts, opts.bmin, opts.bmax, grid);
+		return bakeTile(opts, grid, verts.empty() ? 0 : &verts[0], (int)verts.size() / 3, tris, opts.tx, opts.ty) ? 0 : 1;
+	}
+
+	rcMeshLoaderObj mesh;
+	if (!mesh.load(opts.mesh))
+	{
+		fprintf(stderr, "RecastBake: could not read %s\n", opts.mesh.c_str());
+		return 1;
+	}
+	if (mesh.getTriCount() == 0)
+	{
+		fprintf(stderr, "RecastBake: %s has no triangles\n", opts.mesh.c_str());
+		return 1;
+	}
+
+	BakeGrid grid;
+	if (opts.hasBounds)
+	{
+		initGrid(opts, opts.bmin, opts.bmax, grid);
+	}
+	else
+	{
+		float bmin[3], bmax[3];
+		rcCalcBounds(mesh.getVerts(), mesh.getVertCount(), bmin, bmax);
+		initGrid(opts, bmin, bmax, grid);
+	}
+
+	std::error_code ec;
+	std::filesystem::create_directories(opts.outDir, ec);
+
+	const int tileCount = grid.tilesX * grid.tilesY;
+	std::vector<char> tileOk(tileCount, 0);
+	std::atomic<int> nextTile(0);
+	const auto start = std::chrono::steady_clock::now();
+
+	printf("RecastBake: %d x %d cells, %d x %d tiles, %d workers\n", grid.width, grid.height, grid.tilesX, grid.tilesY, opts.workers);
+
+	std::vector<std::vector<int> > tileTris;
+	binTriangles(opts, grid, mesh.getVerts(), mesh.getTris(), mesh.getTriCount(), tileTris);
+
+	if (opts.workers <= 0)
+	{
+		for (int i = 0; i < tileCount; ++i)
+			tileOk[i] = bakeTile(opts, grid, mesh.getVerts(), mesh.getVertCount(), tileTris[i], i % grid.tilesX, i / grid.tilesX);
+	}
+	else
+	{
+		// Each thread keeps one worker process busy, pulling tiles until none are left.
+		std::vector<std::thread> threads;
+		for (int w = 0; w < rcMin(opts.workers, tileCount); ++w)
+		{
+			threads.push_back(std::thread([&]()
+			{
+				for (int i = nextTile++; i < tileCount; i = nextTile++)
+				{
+					// The triangle file only lives while its worker runs.
+					const int tx = i % grid.tilesX;
+					const int ty = i / grid.tilesX;
+					const std::string trisPath = opts.outDir + "/" + trisFileName(tx, ty);
+					if (!writeTileTris(trisPath.c_str(), mesh.getVerts(), tileTris[i]))
+						continue;
+					std::vector<int>().swap(tileTris[i]);
+					const std::string cmd = workerCommand(argv[0], opts, grid, trisPath, tx, ty);
+					tileOk[i] = std::system(cmd.c_str()) == 0;
+					std::error_code removeEc;
+					std::filesystem::remove(trisPath, removeEc);
+				}
+			}));
+		}
+		for (size_t i = 0; i < threads.size(); ++i)
+			threads[i].join();
+	}
+
+	int failed = 0;
+	for (int i = 0; i < tileCount; ++i)
+	{
+		if (!tileOk[i])
+		{
+			fprintf(stderr, "RecastBake: tile %d %d failed\n", i % grid.tilesX, i / grid.tilesX);
+			failed++;
+		}
+	}
+
+	if (!writeManifest(opts, grid, tileOk))
+	{
+		fprintf(stderr, "RecastBake: could not write the manifest\n");
+		return 1;
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("RecastBake: %d tiles baked, %d failed, %.2fs\n", tileCount - failed, failed, seconds);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,918 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+// Benchmark suite for the Recast core. Runs rasterization, filtering,
+// compaction, the compressed export and a span walk standing in for the SOP
+// output over OBJ meshes and over generated worst cases, and reports the rates
+// as a table and, optionally, as JSON for regression tracking.
+//
+//   RecastBench [mesh.obj ...] [options]
+//
+// Without meshes on the command line it runs the bundled meshes in meshs/.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Recast.h"
+#include "RecastExport.h"
+#include "RecastMath.h"
+#include "RecastMeshLoaderObj.h"
+#include "RecastParallel.h"
+
+#ifndef RC_BUNDLED_MESHES
+#define RC_BUNDLED_MESHES "meshs"
+#endif
+
+/// Tile size of the export, the default tile size of RecastBake. [Units: vx]
+static const int BENCH_EXPORT_TILE = 256;
+
+struct BenchOptions
+{
+	std::vector<std::string> meshes;
+	std::string json;			///< Path of the JSON results, empty for none.
+	std::string only;			///< Runs only the cases whose name contains this.
+	float cs = 0.3f;			///< Cell size of the meshes, the generated cases pick their own.
+	float ch = 0.2f;			///< Cell height of the meshes.
+	float scale = 1.0f;			///< Multiplies the size of the generated cases.
+	int repeat = 3;				///< Runs per measurement, the fastest is kept.
+	int flagMergeThr = 1;
+	bool generated = true;
+	std::vector<int> threads;	///< Thread counts of the scaling runs.
+};
+
+/// A triangle soup to benchmark, with the grid to rasterize it on.
+struct BenchCase
+{
+	std::string name;
+	std::vector<float> verts;
+	std::vector<int> tris;
+	float cs;
+	float ch;
+};
+
+/// Timings of one thread count.
+struct BenchScaling
+{
+	int threads;
+	double rasterize;			///< Triangles split over the threads and merged. [Units: s]
+	double filters;				///< The three walkable filters. [Units: s]
+	double distance;			///< Flattening, erosion and distance field. [Units: s]
+};
+
+struct BenchResult
+{
+	std::string name;
+	int triangles;
+	int width;
+	int height;
+	int heightBits;
+	long long spans;
+	double bytesPerSpan;
+	double rasterize;			///< [Units: s]
+	double sort;				///< Morton sort of the triangles. [Units: s]
+	double sortedRasterize;		///< Rasterizing the sorted triangles. [Units: s]
+	double filters;				///< [Units: s]
+	double compact;				///< [Units: s]
+	size_t reclaimed;			///< Bytes released by the compaction.
+	double output;				///< [Units: s]
+	double columns;				///< Flattening the spans and connecting them. [Units: s]
+	double erode;				///< [Units: s]
+	double distance;			///< [Units: s]
+	double regions;				///< [Units: s]
+	double contours;			///< Tracing and simplifying the contours. [Units: s]
+	int contourCount;
+	long long contourVerts;
+	long long rawBytes;			///< The size of the spans as a tile file. [Units: bytes]
+	long long exportBytes;		///< The size of the compressed export. [Units: bytes]
+	double encode;				///< [Units: s]
+	double decode;				///< [Units: s]
+	std::vector<BenchScaling> scaling;
+};
+
+/// Prints the warnings and errors of the build steps.
+class BenchContext : public rcContext
+{
+protected:
+	virtual void doLog(const rcLogCategory category, const char* msg, const int /*len*/)
+	{
+		if (category != RC_LOG_PROGRESS)
+			fprintf(stderr, "RecastBench: %s\n", msg);
+	}
+};
+
+static double now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// A small deterministic generator, so the generated cases are the same on every run.
+struct BenchRandom
+{
+	unsigned int state;
+	explicit BenchRandom(unsigned int seed) : state(seed) {}
+	float next()
+	{
+		state = state * 1664525u + 1013904223u;
+		return (state >> 8) * (1.0f / 16777216.0f);
+	}
+};
+
+static void addVertex(BenchCase& c, float x, float y, float z)
+{
+	c.verts.push_back(x);
+	c.verts.push_back(y);
+	c.verts.push_back(z);
+}
+
+static void addTriangle(BenchCase& c, int a, int b, int d)
+{
+	c.tris.push_back(a);
+	c.tris.push_back(b);
+	c.tris.push_back(d);
+}
+
+/// Adds a quad given in counter-clockwise order seen from above as two triangles.
+static void addQuad(BenchCase& c, const float* p0, const float* p1, const float* p2, const float* p3)
+{
+	const int base = (int)c.verts.size() / 3;
+	addVertex(c, p0[0], p0[1], p0[2]);
+	addVertex(c, p1[0], p1[1], p1[2]);
+	addVertex(c, p2[0], p2[1], p2[2]);
+	addVertex(c, p3[0], p3[1], p3[2]);
+	addTriangle(c, base, base + 1, base + 2);
+	addTriangle(c, base, base + 2, base + 3);
+}
+
+/// A huge tessellated floor at one height, every triangle takes the flat path.
+static void generateFlatPlane(BenchCase& c, float scale)
+{
+	c.name = "flat_plane";
+	c.cs = 0.25f;
+	c.ch = 0.2f;
+	const int quads = rcMax((int)(128 * sqrtf(scale)), 1);
+	const float size = 4.0f;
+	for (int y = 0; y < quads; ++y)
+	{
+		for (int x = 0; x < quads; ++x)
+		{
+			const float p0[3] = { x * size, 0.0f, y * size };
+			const float p1[3] = { x * size, 0.0f, (y + 1) * size };
+			const float p2[3] = { (x + 1) * size, 0.0f, (y + 1) * size };
+			const float p3[3] = { (x + 1) * size, 0.0f, y * size };
+			addQuad(c, p0, p1, p2, p3);
+		}
+	}
+}
+
+/// Rows of tall zigzag walls, every triangle takes the non-flat path and
+/// covers long columns.
+static void generateCliffs(BenchCase& c, float scale)
+{
+	c.name = "steep_cliffs";
+	c.cs = 0.25f;
+	c.ch = 0.1f;
+	const int walls = rcMax((int)(64 * sqrtf(scale)), 1);
+	const int segments = 64;
+	const float length = 4.0f;
+	const float spacing = 4.0f;
+	const float top = 40.0f;
+	for (int w = 0; w < walls; ++w)
+	{
+		for (int s = 0; s < segments; ++s)
+		{
+			const float z0 = w * spacing + ((s & 1) ? 0.75f : 0.0f);
+			const float z1 = w * spacing + ((s & 1) ? 0.0f : 0.75f);
+			const float p0[3] = { s * length, 0.0f, z0 };
+			const float p1[3] = { s * length, top, z0 + 0.5f };
+			const float p2[3] = { (s + 1) * length, top, z1 + 0.5f };
+			const float p3[3] = { (s + 1) * length, 0.0f, z1 };
+			addQuad(c, p0, p1, p2, p3);
+		}
+	}
+}
+
+/// Tiny scattered triangles that each land inside a single cell.
+static void generateSubCell(BenchCase& c, float scale)
+{
+	c.name = "sub_cell";
+	c.cs = 0.3f;
+	c.ch = 0.2f;
+	const int count = rcMax((int)(1000000 * scale), 1);
+	const float area = 300.0f * sqrtf(scale);
+	BenchRandom rnd(1);
+	for (int i = 0; i < count; ++i)
+	{
+		// Keep the triangle inside one cell so the single-cell path is taken.
+		const float x = (floorf(rnd.next() * area / c.cs) + 0.1f) * c.cs;
+		const float z = (floorf(rnd.next() * area / c.cs) + 0.1f) * c.cs;
+		const float y = rnd.next() * 20.0f;
+		const int base = (int)c.verts.size() / 3;
+		addVertex(c, x, y, z);
+		addVertex(c, x + rnd.next() * c.cs * 0.8f, y + rnd.next(), z + c.cs * 0.8f);
+		addVertex(c, x + c.cs * 0.8f, y + rnd.next(), z + rnd.next() * c.cs * 0.8f);
+		addTriangle(c, base, base + 1, base + 2);
+	}
+}
+
+/// Many floors stacked over the same area, then a second set just above
+/// them, so every column holds a long span list and each second floor
+/// merges into the span below it.
+static void generateStacks(BenchCase& c, float scale)
+{
+	c.name = "deep_stacks";
+	c.cs = 0.3f;
+	c.ch = 0.1f;
+	const int layers = rcMax((int)(48 * scale), 1);
+	const float size = 48.0f;
+	const float spacing = 0.45f;
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		for (int l = 0; l < layers; ++l)
+		{
+			const float y = l * spacing + pass * 0.15f;
+			const float p0[3] = { 0.0f, y, 0.0f };
+			const float p1[3] = { 0.0f, y + 0.05f, size };
+			const float p2[3] = { size, y + 0.1f, size };
+			const float p3[3] = { size, y + 0.05f, 0.0f };
+			addQuad(c, p0, p1, p2, p3);
+		}
+	}
+}
+
+/// Long, nearly degenerate triangles crossing the whole level at random angles.
+static void generateSlivers(BenchCase& c, float scale)
+{
+	c.name = "long_slivers";
+	c.cs = 0.25f;
+	c.ch = 0.2f;
+	const int count = rcMax((int)(5000 * scale), 1);
+	const float area = 200.0f;
+	BenchRandom rnd(2);
+	for (int i = 0; i < count; ++i)
+	{
+		const float angle = rnd.next() * 6.2831853f;
+		const float dx = cosf(angle) * area * 0.5f;
+		const float dz = sinf(angle) * area * 0.5f;
+		const float cx = area * 0.5f;
+		const float cz = area * 0.5f;
+		const float y = rnd.next() * 10.0f;
+		const int base = (int)c.verts.size() / 3;
+		addVertex(c, cx - dx, y, cz - dz);
+		addVertex(c, cx + dx, y + 1.0f, cz + dz);
+		addVertex(c, cx + dx - dz * 0.0002f, y + 1.0f, cz + dz + dx * 0.0002f);
+		addTriangle(c, base, base + 1, base + 2);
+	}
+}
+
+template<class Layout>
+static long long countSpans(const rcHeightfieldT<Layout>& hf)
+{
+	long long count = 0;
+	for (int i = 0; i < hf.brickWidth * hf.brickHeight; ++i)
+	{
+		const rcSpanBrickT<Layout>* brick = hf.bricks[i];
+		if (!brick)
+			continue;
+		for (int c = 0; c < RC_BRICK_SIZE * RC_BRICK_SIZE; ++c)
+		{
+			for (const rcSpanT<Layout>* s = brick->spans[c]; s; s = s->next)
+				count++;
+		}
+	}
+	return count;
+}
+
+/// The memory held by the spans of @p hf: span pools, bricks and the brick and group grids.
+template<class Layout>
+static size_t heightfieldBytes(const rcHeightfieldT<Layout>& hf)
+{
+	size_t bytes = sizeof(rcSpanBrickT<Layout>*) * hf.brickWidth * hf.brickHeight;
+	bytes += sizeof(rcBrickGroup) * hf.groupWidth * hf.groupHeight;
+	bytes += sizeof(rcSpanBrickT<Layout>) * hf.brickCount;
+	for (const rcSpanPoolT<Layout>* pool = hf.pools; pool; pool = pool->next)
+		bytes += sizeof(rcSpanPoolT<Layout>);
+	return bytes;
+}
+
+/// Walks every span through the occupancy pyramid and writes its box corners,
+/// like the span output of the SOP does. Returns the number of floats written.
+template<class Layout>
+static size_t walkSpans(const rcHeightfieldT<Layout>& hf, std::vector<float>& out)
+{
+	out.clear();
+	for (int gi = 0; gi < hf.groupWidth * hf.groupHeight; ++gi)
+	{
+		const int gx = gi % hf.groupWidth;
+		const int gy = gi / hf.groupWidth;
+		for (unsigned long long bricks = hf.groups[gi].brickMask; bricks; bricks &= bricks - 1)
+		{
+			const int bit = rcLowestBit64(bricks);
+			const int bx = (gx << RC_GROUP_SHIFT) + (bit & RC_GROUP_MASK);
+			const int by = (gy << RC_GROUP_SHIFT) + (bit >> RC_GROUP_SHIFT);
+			const rcSpanBrickT<Layout>* brick = hf.bricks[bx + by * hf.brickWidth];
+			for (int ly = 0; ly < RC_BRICK_SIZE; ++ly)
+			{
+				for (unsigned int columns = brick->rowMask[ly]; columns; columns &= columns - 1)
+				{
+					const int lx = rcLowestBit(columns);
+					const float x = hf.bmin[0] + ((bx << RC_BRICK_SHIFT) + lx) * hf.cs;
+					const float z = hf.bmin[2] + ((by << RC_BRICK_SHIFT) + ly) * hf.cs;
+					for (const rcSpanT<Layout>* s = brick->spans[rcBrickColumnIndex(lx, ly)]; s; s = s->next)
+					{
+						const float ymin = hf.bmin[1] + s->data.smin * hf.ch;
+						const float ymax = hf.bmin[1] + s->data.smax * hf.ch;
+						for (int k = 0; k < 8; ++k)
+						{
+							out.push_back(x + ((k & 4) ? hf.cs : 0.0f));
+							out.push_back((k & 2) ? ymax : ymin);
+							out.push_back(z + ((k & 1) ? hf.cs : 0.0f));
+						}
+					}
+				}
+			}
+		}
+	}
+	return out.size();
+}
+
+/// The grid a case is rasterized on, fit around its vertices like the SOP does.
+struct BenchGrid
+{
+	float bmin[3];
+	float bmax[3];
+	int width;
+	int height;
+};
+
+template<class Layout>
+static rcHeightfieldT<Layout>* createHeightfield(const BenchCase& c, const BenchGrid& grid)
+{
+	rcHeightfieldT<Layout>* hf = rcAllocHeightfield<Layout>();
+	if (!hf || !rcCreateHeightfield(*hf, grid.width, grid.height, grid.bmin, grid.bmax, c.cs, c.ch))
+	{
+		rcFreeHeightField(hf);
+		return 0;
+	}
+	return hf;
+}
+
+/// Rasterizes @p c with every thread taking a contiguous share of the triangles
+/// into its own heightfield, then merges them.
+template<class Layout>
+static rcHeightfieldT<Layout>* rasterizeThreaded(const BenchCase& c, const BenchGrid& grid, const std::vector<unsigned char>& areas,
+												 int nthreads, int flagMergeThr)
+{
+	const int ntris = (int)c.tris.size() / 3;
+	const int nverts = (int)c.verts.size() / 3;
+	rcHeightfieldT<Layout>* dest = createHeightfield<Layout>(c, grid);
+	if (!dest)
+		return 0;
+	BenchContext ctx;
+	if (nthreads <= 1)
+	{
+		if (!rcRasterizeTriangles(&ctx, &c.verts[0], nverts, &c.tris[0], &areas[0], ntris, *dest, flagMergeThr))
+		{
+			rcFreeHeightField(dest);
+			return 0;
+		}
+		return dest;
+	}
+
+	std::vector<rcHeightfieldT<Layout>*> parts(nthreads, (rcHeightfieldT<Layout>*)0);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < nthreads; ++t)
+	{
+		threads.push_back(std::thread([&, t]()
+		{
+			const int first = (int)((long long)ntris * t / nthreads);
+			const int last = (int)((long long)ntris * (t + 1) / nthreads);
+			parts[t] = createHeightfield<Layout>(c, grid);
+			if (parts[t] && last > first &&
+				!rcRasterizeTriangles(&ctx, &c.verts[0], nverts, &c.tris[first * 3], &areas[first], last - first, *parts[t], flagMergeThr))
+			{
+				rcFreeHeightField(parts[t]);
+				parts[t] = 0;
+			}
+		}));
+	}
+	for (size_t i = 0; i < threads.size(); ++i)
+		threads[i].join();
+
+	bool ok = true;
+	for (int t = 0; t < nthreads; ++t)
+		ok = ok && parts[t];
+	if (ok)
+		ok = rcMergeHeightfields(&parts[0], nthreads, *dest, flagMergeThr);
+	for (int t = 0; t < nthreads; ++t)
+		rcFreeHeightField(parts[t]);
+	if (!ok)
+	{
+		rcFreeHeightField(dest);
+		return 0;
+	}
+	return dest;
+}
+
+template<class Layout>
+static void runFilters(const BenchCase& c, rcHeightfieldT<Layout>& hf)
+{
+	// The defaults of the SOP: 2 units of walkable height and 0.9 of climb.
+	const int walkableHeight = (int)ceilf(2.0f / c.ch);
+	const int walkableClimb = (int)floorf(0.9f / c.ch);
+	rcFilterLowHangingWalkableObstacles(walkableClimb, hf);
+	rcFilterLedgeSpans(walkableHeight, walkableClimb, hf);
+	rcFilterWalkableLowHeightSpans(walkableHeight, hf);
+}
+
+/// Flattens @p hf, erodes it by the radius of the SOP's agent and builds the distance field.
+/// Returns false if out of memory.
+template<class Layout>
+static bool runDistance(const BenchCase& c, const rcHeightfieldT<Layout>& hf, double& columns, double& erode, double& distance,
+						BenchResult* contours = 0)
+{
+	const int walkableHeight = (int)ceilf(2.0f / c.ch);
+	const int walkableClimb = (int)floorf(0.9f / c.ch);
+	const int walkableRadius = (int)ceilf(0.6f / c.cs);
+	rcColumnHeightfield* chf = rcAllocColumnHeightfield();
+	double start = now();
+	bool ok = chf && rcBuildColumnHeightfield(hf, *chf) && rcBuildColumnConnections(walkableHeight, walkableClimb, *chf);
+	columns = now() - start;
+	start = now();
+	ok = ok && rcErodeWalkableArea(walkableRadius, *chf);
+	erode = now() - start;
+	start = now();
+	ok = ok && rcBuildDistanceField(*chf);
+	distance = now() - start;
+
+	if (ok && contours)
+	{
+		// The SOP's default max error of 0.25 units.
+		rcContourSet* cset = rcAllocContourSet();
+		start = now();
+		BenchContext ctx;
+		ok = cset && rcBuildColumnRegions(&ctx, *chf);
+		contours->regions = rcMin(contours->regions, now() - start);
+		start = now();
+		ok = ok && rcBuildContours(&ctx, *chf, 0.25f / c.cs, 0, *cset);
+		contours->contours = rcMin(contours->contours, now() - start);
+		if (ok)
+		{
+			contours->contourCount = cset->nconts;
+			contours->contourVerts = 0;
+			for (int i = 0; i < cset->nconts; ++i)
+				contours->contourVerts += cset->conts[i].nverts;
+		}
+		rcFreeContourSet(cset);
+	}
+	rcFreeColumnHeightfield(chf);
+	return ok;
+}
+
+template<class Layout>
+static bool runCase(const BenchCase& c, const BenchGrid& grid, const BenchOptions& opts, BenchResult& result)
+{
+	const int ntris = (int)c.tris.size() / 3;
+	const int nverts = (int)c.verts.size() / 3;
+	const std::vector<unsigned char> areas(ntris, RC_WALKABLE_AREA);
+
+	result.name = c.name;
+	result.triangles = ntris;
+	result.width = grid.width;
+	result.height = grid.height;
+	result.heightBits = Layout::HeightBits;
+	result.rasterize = result.sort = result.sortedRasterize = result.filters = result.compact = result.output = result.encode = result.decode = 1e30;
+	result.columns = result.erode = result.distance = result.regions = result.contours = 1e30;
+	result.contourCount = 0;
+	result.contourVerts = 0;
+	result.reclaimed = 0;
+
+	BenchContext ctx;
+	std::vector<float> corners;
+	for (int run = 0; run < opts.repeat; ++run)
+	{
+		std::vector<int> sortedTris(c.tris);
+		std::vector<unsigned char> sortedAreas(areas);
+		rcHeightfieldT<Layout>* sorted = createHeightfield<Layout>(c, grid);
+		if (!sorted)
+			return false;
+		double start = now();
+		if (!rcSortTrianglesMorton(&c.verts[0], &sortedTris[0], &sortedAreas[0], ntris, grid.bmin, c.cs, grid.width, grid.height))
+		{
+			rcFreeHeightField(sorted);
+			return false;
+		}
+		result.sort = rcMin(result.sort, now() - start);
+		start = now();
+		if (!rcRasterizeTriangles(&ctx, &c.verts[0], nverts, &sortedTris[0], &sortedAreas[0], ntris, *sorted, opts.flagMergeThr))
+		{
+			rcFreeHeightField(sorted);
+			return false;
+		}
+		result.sortedRasterize = rcMin(result.sortedRasterize, now() - start);
+		rcFreeHeightField(sorted);
+
+		rcHeightfieldT<Layout>* hf = createHeightfield<Layout>(c, grid);
+		if (!hf)
+			return false;
+
+		start = now();
+		if (!rcRasterizeTriangles(&ctx, &c.verts[0], nverts, &c.tris[0], &areas[0], ntris, *hf, opts.flagMergeThr))
+		{
+			rcFreeHeightField(hf);
+			return false;
+		}
+		result.rasterize = rcMin(result.rasterize, now() - start);
+
+		result.spans = countSpans(*hf);
+		result.bytesPerSpan = result.spans ? (double)heightfieldBytes(*hf) / result.spans : 0.0;
+
+		start = now();
+		runFilters(c, *hf);
+		result.filters = rcMin(result.filters, now() - start);
+
+		start = now();
+		result.reclaimed = rcCompactSpanPools(*hf);
+		result.compact = rcMin(result.compact, now() - start);
+
+		start = now();
+		walkSpans(*hf, corners);
+		result.output = rcMin(result.output, now() - start);
+
+		double columns, erode, distance;
+		if (!runDistance(c, *hf, columns, erode, distance, &result))
+		{
+			rcFreeHeightField(hf);
+			return false;
+		}
+		result.columns = rcMin(result.columns, columns);
+		result.erode = rcMin(result.erode, erode);
+		result.distance = rcMin(result.distance, distance);
+
+		// A tile file stores a 16-bit count per column and 5 bytes per span.
+		result.rawBytes = 2LL*grid.width*grid.height + 5LL*result.spans;
+		rcExportBuffer exported;
+		start = now();
+		if (!rcEncodeHeightfield(*hf, 0, 0, grid.width, grid.height, BENCH_EXPORT_TILE, 0, 0, exported))
+		{
+			rcFreeHeightField(hf);
+			return false;
+		}
+		result.encode = rcMin(result.encode, now() - start);
+		result.exportBytes = exported.size;
+		rcFreeHeightField(hf);
+
+		hf = rcAllocHeightfield<Layout>();
+		rcExportHeader header;
+		start = now();
+		const bool decoded = hf && rcDecodeHeightfield(exported.data, exported.size, 0, 0, *hf, header);
+		result.decode = rcMin(result.decode, now() - start);
+		rcFreeExportBuffer(exported);
+		if (!decoded || countSpans(*hf) != result.spans)
+		{
+			rcFreeHeightField(hf);
+			return false;
+		}
+
+		rcFreeHeightField(hf);
+	}
+
+	for (size_t i = 0; i < opts.threads.size(); ++i)
+	{
+		BenchScaling scaling;
+		scaling.threads = opts.threads[i];
+		scaling.rasterize = scaling.filters = scaling.distance = 1e30;
+		rcParallelSetThreadCount(scaling.threads);
+		for (int run = 0; run < opts.repeat; ++run)
+		{
+			double start = now();
+			rcHeightfieldT<Layout>* hf = rasterizeThreaded<Layout>(c, grid, areas, scaling.threads, opts.flagMergeThr);
+			if (!hf)
+				return false;
+			scaling.rasterize = rcMin(scaling.rasterize, now() - start);
+
+			start = now();
+			runFilters(c, *hf);
+			scaling.filters = rcMin(scaling.filters, now() - start);
+
+			double columns, erode, distance;
+			const bool ok = runDistance(c, *hf, columns, erode, distance);
+			rcFreeHeightField(hf);
+			if (!ok)
+				return false;
+			scaling.distance = rcMin(scaling.distance, columns + erode + distance);
+		}
+		result.scaling.push_back(scaling);
+	}
+	rcParallelSetThreadCount(0);
+	return true;
+}
+
+static bool benchCase(const BenchCase& c, const BenchOptions& opts, BenchResult& result)
+{
+	if (c.tris.empty())
+		return false;
+
+	BenchGrid grid;
+	rcCalcBounds(&c.verts[0], (int)c.verts.size() / 3, grid.bmin, grid.bmax);
+	grid.width = (int)floorf((grid.bmax[0] - grid.bmin[0]) / c.cs) + 1;
+	grid.height = (int)floorf((grid.bmax[2] - grid.bmin[2]) / c.cs) + 1;
+	grid.bmax[0] = grid.bmin[0] + grid.width * c.cs;
+	grid.bmax[2] = grid.bmin[2] + grid.height * c.cs;
+
+	// Pick the span layout by the vertical resolution, like the SOP does.
+	const int spanHeight = (int)ceilf((grid.bmax[1] - grid.bmin[1]) / c.ch);
+	if (spanHeight <= rcSpanLayoutCompact::MaxHeight)
+		return runCase<rcSpanLayoutCompact>(c, grid, opts, result);
+	return runCase<rcSpanLayoutTall>(c, grid, opts, result);
+}
+
+static void printResult(const BenchResult& r)
+{
+	printf("%-16s %9d tris %5d x %-5d %10lld spans  raster %8.3f s %7.2f Mtri/s %7.2f Mspan/s  %5.1f B/span"
+		"  filters %7.3f s  compact %6.3f s  output %6.3f s\n",
+		r.name.c_str(), r.triangles, r.width, r.height, r.spans, r.rasterize,
+		r.triangles / r.rasterize * 1e-6, r.spans / r.rasterize * 1e-6, r.bytesPerSpan,
+		r.filters, r.compact, r.output);
+	printf("%-16s   sorted   sort %6.3f s  raster %8.3f s (x%.2f with the sort)\n", "",
+		r.sort, r.sortedRasterize, r.rasterize / (r.sort + r.sortedRasterize));
+	printf("%-16s   columns %6.3f s  erode %6.3f s  distance field %6.3f s  regions %6.3f s  contours %6.3f s (%d contours, %lld vertices)\n", "",
+		r.columns, r.erode, r.distance, r.regions, r.contours, r.contourCount, r.contourVerts);
+	printf("%-16s   export %12lld bytes (%5.2fx smaller than tiles)  encode %6.3f s %6.2f GB/s  decode %6.3f s %6.2f GB/s\n", "",
+		r.exportBytes, (double)r.rawBytes / r.exportBytes, r.encode, r.rawBytes / r.encode * 1e-9, r.decode, r.rawBytes / r.decode * 1e-9);
+	for (size_t i = 0; i < r.scaling.size(); ++i)
+	{
+		const BenchScaling& s = r.scaling[i];
+		printf("%-16s   %2d threads  raster+merge %8.3f s (x%.2f)  filters %7.3f s (x%.2f)  distance %7.3f s (x%.2f)\n", "",
+			s.threads, s.rasterize, r.scaling[0].rasterize / s.rasterize, s.filters, r.scaling[0].filters / s.filters,
+			s.distance, r.scaling[0].distance / s.distance);
+	}
+}
+
+/// Writes a JSON string, escaping quotes, backslashes and control characters.
+static void writeJsonString(FILE* fp, const std::string& s)
+{
+	fputc('"', fp);
+	for (size_t i = 0; i < s.size(); ++i)
+	{
+		const unsigned char c = (unsigned char)s[i];
+		if (c == '"' || c == '\\')
+			fprintf(fp, "\\%c", c);
+		else if (c < 0x20)
+			fprintf(fp, "\\u%04x", c);
+		else
+			fputc(c, fp);
+	}
+	fputc('"', fp);
+}
+
+/// Formats a number for JSON, null if it is not finite, such as a rate over a zero time.
+static std::string jsonNumber(double value, const char* format = "%.6f")
+{
+	if (!isfinite(value))
+		return "null";
+	char buf[64];
+	snprintf(buf, sizeof(buf), format, value);
+	return buf;
+}
+
+static bool writeJson(const std::string& path, const std::vector<BenchResult>& results)
+{
+	FILE* fp = fopen(path.c_str(), "w");
+	if (!fp)
+		return false;
+
+	fprintf(fp, "{\n  \"hardwareThreads\": %u,\n  \"cases\": [\n", std::thread::hardware_concurrency());
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const BenchResult& r = results[i];
+		fprintf(fp, "    {\n");
+		fprintf(fp, "      \"name\": ");
+		writeJsonString(fp, r.name);
+		fprintf(fp, ",\n");
+		fprintf(fp, "      \"triangles\": %d,\n      \"width\": %d,\n      \"height\": %d,\n", r.triangles, r.width, r.height);
+		fprintf(fp, "      \"heightBits\": %d,\n      \"spans\": %lld,\n      \"bytesPerSpan\": %s,\n",
+			r.heightBits, r.spans, jsonNumber(r.bytesPerSpan, "%.3f").c_str());
+		fprintf(fp, "      \"rasterizeSeconds\": %s,\n", jsonNumber(r.rasterize).c_str());
+		fprintf(fp, "      \"trianglesPerSecond\": %s,\n", jsonNumber(r.triangles / r.rasterize, "%.1f").c_str());
+		fprintf(fp, "      \"spansPerSecond\": %s,\n", jsonNumber(r.spans / r.rasterize, "%.1f").c_str());
+		fprintf(fp, "      \"sortSeconds\": %s,\n      \"sortedRasterizeSeconds\": %s,\n",
+			jsonNumber(r.sort).c_str(), jsonNumber(r.sortedRasterize).c_str());
+		fprintf(fp, "      \"filtersSeconds\": %s,\n", jsonNumber(r.filters).c_str());
+		fprintf(fp, "      \"compactSeconds\": %s,\n      \"compactReclaimedBytes\": %llu,\n",
+			jsonNumber(r.compact).c_str(), (unsigned long long)r.reclaimed);
+		fprintf(fp, "      \"outputSeconds\": %s,\n", jsonNumber(r.output).c_str());
+		fprintf(fp, "      \"columnsSeconds\": %s,\n      \"erodeSeconds\": %s,\n      \"distanceSeconds\": %s,\n",
+			jsonNumber(r.columns).c_str(), jsonNumber(r.erode).c_str(), jsonNumber(r.distance).c_str());
+		fprintf(fp, "      \"regionsSeconds\": %s,\n      \"contoursSeconds\": %s,\n",
+			jsonNumber(r.regions).c_str(), jsonNumber(r.contours).c_str());
+		fprintf(fp, "      \"contours\": %d,\n      \"contourVertices\": %lld,\n", r.contourCount, r.contourVerts);
+		fprintf(fp, "      \"rawBytes\": %lld,\n      \"exportBytes\": %lld,\n", r.rawBytes, r.exportBytes);
+		fprintf(fp, "      \"encodeSeconds\": %s,\n      \"decodeSeconds\": %s,\n",
+			jsonNumber(r.encode).c_str(), jsonNumber(r.decode).c_str());
+		fprintf(fp, "      \"scaling\": [");
+		for (size_t j = 0; j < r.scaling.size(); ++j)
+		{
+			const BenchScaling& s = r.scaling[j];
+			fprintf(fp, "%s\n        { \"threads\": %d, \"rasterizeSeconds\": %s, \"filtersSeconds\": %s, \"distanceSeconds\": %s }",
+				j ? "," : "", s.threads, jsonNumber(s.rasterize).c_str(), jsonNumber(s.filters).c_str(), jsonNumber(s.distance).c_str());
+		}
+		fprintf(fp, "%s]\n    }%s\n", r.scaling.empty() ? "" : "\n      ", i + 1 < results.size() ? "," : "");
+	}
+	fprintf(fp, "  ]\n}\n");
+
+	return fclose(fp) == 0;
+}
+
+static void printUsage()
+{
+	printf("usage: RecastBench [mesh.obj ...] [options]\n"
+		"  (without meshes, the bundled meshes in " RC_BUNDLED_MESHES " are run)\n"
+		"  --cs <size>             cell size of the meshes (0.3)\n"
+		"  --ch <size>             cell height of the meshes (0.2)\n"
+		"  --scale <factor>        size of the generated cases (1)\n"
+		"  --repeat <count>        runs per measurement, the fastest is kept (3)\n"
+		"  --threads <list>        comma separated thread counts to scale over (1,2,4,.. up to the hardware threads)\n"
+		"  --merge <voxels>        flagMergeThr of the rasterizer (1)\n"
+		"  --only <name>           run only the cases whose name contains this\n"
+		"  --no-generated          skip the generated cases\n"
+		"  --json <path>           write the results as JSON\n");
+}
+
+static bool parseOptions(int argc, char** argv, BenchOptions& opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if (strcmp(arg, "--cs") == 0 && hasValue)
+			opts.cs = (float)atof(argv[++i]);
+		else if (strcmp(arg, "--ch") == 0 && hasValue)
+			opts.ch = (float)atof(argv[++i]);
+		else if (strcmp(arg, "--scale") == 0 && hasValue)
+			opts.scale = (float)atof(argv[++i]);
+		else if (strcmp(arg, "--repeat") == 0 && hasValue)
+			opts.repeat = atoi(argv[++i]);
+		else if (strcmp(arg, "--merge") == 0 && hasValue)
+			opts.flagMergeThr = atoi(argv[++i]);
+		else if (strcmp(arg, "--only") == 0 && hasValue)
+			opts.only = argv[++i];
+		else if (strcmp(arg, "--json") == 0 && hasValue)
+			opts.json = argv[++i];
+		else if (strcmp(arg, "--no-generated") == 0)
+			opts.generated = false;
+		else if (strcmp(arg, "--threads") == 0 && hasValue)
+		{
+			for (const char* p = argv[++i]; *p; )
+			{
+				opts.threads.push_back(atoi(p));
+				while (*p && *p != ',')
+					p++;
+				if (*p == ',')
+					p++;
+			}
+		}
+		else if (arg[0] == '-')
+		{
+			fprintf(stderr, "RecastBench: unknown option %s\n", arg);
+			return false;
+		}
+		else
+			opts.meshes.push_back(arg);
+	}
+
+	if (opts.threads.empty())
+	{
+		const int hardware = rcMax((int)std::thread::hardware_concurrency(), 1);
+		for (int t = 1; t < hardware; t *= 2)
+			opts.threads.push_back(t);
+		opts.threads.push_back(hardware);
+	}
+	for (size_t i = 0; i < opts.threads.size(); ++i)
+	{
+		if (opts.threads[i] <= 0)
+			return false;
+	}
+
+	return opts.cs > 0.0f && opts.ch > 0.0f && opts.scale > 0.0f && opts.repeat > 0;
+}
+
+int main(int argc, char** argv)
+{
+	rcParallelSetCustom(rcParallelForThreads);
+
+	BenchOptions opts;
+	if (!parseOptions(argc, argv, opts))
+	{
+		printUsage();
+		return 1;
+	}
+
+	if (opts.meshes.empty() && !rcFindObjFiles(RC_BUNDLED_MESHES, opts.meshes))
+		fprintf(stderr, "RecastBench: no meshes given and none found in %s\n", RC_BUNDLED_MESHES);
+
+	typedef void (*BenchGenerator)(BenchCase&, float);
+	std::vector<BenchGenerator> generators;
+	if (opts.generated)
+	{
+		generators.push_back(generateFlatPlane);
+		generators.push_back(generateCliffs);
+		generators.push_back(generateSubCell);
+		generators.push_back(generateStacks);
+		generators.push_back(generateSlivers);
+	}
+
+	std::vector<BenchResult> results;
+	bool ok = true;
+	for (size_t i = 0; i < opts.meshes.size() + generators.size(); ++i)
+	{
+		BenchCase c;
+		if (i < opts.meshes.size())
+		{
+			const std::string& path = opts.meshes[i];
+			if (!opts.only.empty() && path.find(opts.only) == std::string::npos)
+				continue;
+
+			rcMeshLoaderObj mesh;
+			if (!mesh.load(path))
+			{
+				fprintf(stderr, "RecastBench: could not read %s\n", path.c_str());
+				ok = false;
+				continue;
+			}
+			if (mesh.getTriCount() == 0)
+			{
+				fprintf(stderr, "RecastBench: %s has no triangles, is it fetched from LFS?\n", path.c_str());
+				ok = false;
+				continue;
+			}
+			c.name = path;
+			c.cs = opts.cs;
+			c.ch = opts.ch;
+			c.verts.assign(mesh.getVerts(), mesh.getVerts() + mesh.getVertCount() * 3);
+			c.tris.assign(mesh.getTris(), mesh.getTris() + mesh.getTriCount() * 3);
+		}
+		else
+		{
+			generators[i - opts.meshes.size()](c, opts.scale);
+			if (!opts.only.empty() && c.name.find(opts.only) == std::string::npos)
+				continue;
+		}
+
+		BenchResult result;
+		if (!benchCase(c, opts, result))
+		{
+			fprintf(stderr, "RecastBench: %s failed\n", c.name.c_str());
+			ok = false;
+			continue;
+		}
+		printResult(result);
+		fflush(stdout);
+		results.push_back(result);
+	}
+
+	if (!opts.json.empty() && !writeJson(opts.json, results))
+	{
+		fprintf(stderr, "RecastBench: could not write %s\n", opts.json.c_str());
+		return 1;
+	}
+
+	return ok ? 0 : 1;
+}
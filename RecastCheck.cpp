@@ -0,0 +1,607 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <string>
+#include <vector>
+
+#include "Recast.h"
+#include "RecastExport.h"
+#include "RecastMath.h"
+#include "RecastMeshLoaderObj.h"
+#include "RecastParallel.h"
+
+#ifndef RC_BUNDLED_MESHES
+#define RC_BUNDLED_MESHES "meshs"
+#endif
+
+/// The span bound difference the rasterizer checks accept. The rasterizer snaps
+/// its samples down while the reference rounds the top of its span up.
+static const int CHECK_TOLERANCE = 1;
+
+/// Random triangles per fuzz seed.
+static const int CHECK_FUZZ_TRIANGLES = 2000;
+
+struct CheckOptions
+{
+	std::vector<std::string> meshes;	///< Meshes to check, the bundled ones if empty.
+	std::string meshDir = RC_BUNDLED_MESHES;
+	std::string only;			///< Runs only the checks whose name contains this.
+	float cs = 0.3f;			///< Cell size of the meshes.
+	float ch = 0.2f;			///< Cell height of the meshes.
+	int seeds = 64;				///< Fuzz seeds, run as 1..seeds.
+};
+
+/// Prints the counters of a rasterizer check.
+///  @return False if a column is missing or off by more than the tolerance.
+static bool reportRasterizer(const char* name, const rcRasterizerCheck& check)
+{
+	const bool ok = check.missing == 0 && check.mismatched == 0;
+	printf("%-40s %8d tris %9d cells %6d missing %6d extra %6d mismatched  max error %d  %s\n",
+		   name, check.triangles, check.cells, check.missing, check.extra, check.mismatched, check.maxError,
+		   ok ? "ok" : "FAILED");
+	return ok;
+}
+
+/// Runs the rasterizer fuzzer over the seeds, reporting every failing seed so it can be replayed.
+template<class Layout>
+static bool checkFuzz(const char* layoutName, const CheckOptions& opts)
+{
+	rcRasterizerCheck total = {};
+	bool ok = true;
+	for (int seed = 1; seed <= opts.seeds; ++seed)
+	{
+		rcRasterizerCheck check = {};
+		if (!rcFuzzRasterizer<Layout>((unsigned int)seed, CHECK_FUZZ_TRIANGLES, CHECK_TOLERANCE, check))
+		{
+			fprintf(stderr, "RecastCheck: out of memory fuzzing seed %d\n", seed);
+			return false;
+		}
+		if (check.missing || check.mismatched)
+		{
+			fprintf(stderr, "RecastCheck: %s fuzz seed %d failed\n", layoutName, seed);
+			ok = false;
+		}
+		total.triangles += check.triangles;
+		total.cells += check.cells;
+		total.missing += check.missing;
+		total.extra += check.extra;
+		total.mismatched += check.mismatched;
+		total.maxError = rcMax(total.maxError, check.maxError);
+	}
+
+	char name[64];
+	snprintf(name, sizeof(name), "fuzz %s (%d seeds)", layoutName, opts.seeds);
+	return reportRasterizer(name, total) && ok;
+}
+
+/// Adds the two triangles of a quad.
+static void addQuad(std::vector<float>& verts, std::vector<int>& tris, const float* a, const float* b, const float* c, const float* d)
+{
+	const int first = (int)verts.size() / 3;
+	verts.insert(verts.end(), a, a + 3);
+	verts.insert(verts.end(), b, b + 3);
+	verts.insert(verts.end(), c, c + 3);
+	verts.insert(verts.end(), d, d + 3);
+	const int quad[6] = { first, first + 1, first + 2, first, first + 2, first + 3 };
+	tris.insert(tris.end(), quad, quad + 6);
+}
+
+/// Prints the warnings and errors of the build steps.
+class CheckContext : public rcContext
+{
+protected:
+	virtual void doLog(const rcLogCategory category, const char* msg, const int /*len*/)
+	{
+		if (category != RC_LOG_PROGRESS)
+			fprintf(stderr, "RecastCheck: %s\n", msg);
+	}
+};
+
+static int findSpanRoot(std::vector<int>& parents, int i)
+{
+	while (parents[i] != i)
+	{
+		parents[i] = parents[parents[i]];
+		i = parents[i];
+	}
+	return i;
+}
+
+/// Groups the walkable spans with a serial union-find over the connections taken both
+/// ways, the same as a serial flood fill, which #rcBuildColumnRegions must reproduce.
+///  @return The number of regions.
+static int serialRegions(const rcColumnHeightfield& chf, std::vector<int>& roots)
+{
+	std::vector<int> parents(chf.spanCount);
+	for (int i = 0; i < chf.spanCount; ++i)
+		parents[i] = i;
+	for (int y = 0; y < chf.height; ++y)
+	{
+		for (int x = 0; x < chf.width; ++x)
+		{
+			const int c = x + y*chf.width;
+			for (unsigned int i = chf.cells[c]; i < chf.cells[c + 1]; ++i)
+			{
+				if (chf.areas[i] == RC_NULL_AREA)
+					continue;
+				for (int dir = 0; dir < 4; ++dir)
+				{
+					const int ni = rcGetColumnNeighbour(chf, x, y, i, dir);
+					if (ni >= 0 && chf.areas[ni] == chf.areas[i])
+						parents[findSpanRoot(parents, (int)i)] = findSpanRoot(parents, ni);
+				}
+			}
+		}
+	}
+
+	int nregions = 0;
+	roots.assign(chf.spanCount, -1);
+	for (int i = 0; i < chf.spanCount; ++i)
+	{
+		if (chf.areas[i] == RC_NULL_AREA)
+			continue;
+		roots[i] = findSpanRoot(parents, i);
+		if (roots[i] == i)
+			nregions++;
+	}
+	return nregions;
+}
+
+/// Builds the regions of a heightfield and checks they partition the walkable spans
+/// exactly as the serial flood fill does, up to the numbering.
+template<class Layout>
+static bool checkRegions(const std::string& name, const rcHeightfieldT<Layout>& hf, const int walkableHeight, const int walkableClimb)
+{
+	CheckContext ctx;
+	rcColumnHeightfield* chf = rcAllocColumnHeightfield();
+	if (!chf || !rcBuildColumnHeightfield(hf, *chf) || !rcBuildColumnConnections(walkableHeight, walkableClimb, *chf) ||
+		!rcBuildColumnRegions(&ctx, *chf))
+	{
+		fprintf(stderr, "RecastCheck: could not build the regions of %s\n", name.c_str());
+		rcFreeColumnHeightfield(chf);
+		return false;
+	}
+
+	std::vector<int> roots;
+	const int nregions = serialRegions(*chf, roots);
+
+	// Every serial region maps to one region id and back.
+	std::vector<int> idOfRoot(chf->spanCount, -1);
+	std::vector<int> rootOfId(chf->maxRegions + 1, -1);
+	int mismatched = 0;
+	for (int i = 0; i < chf->spanCount; ++i)
+	{
+		const int reg = chf->regs[i];
+		if (roots[i] < 0 || reg == 0)
+		{
+			mismatched += (roots[i] < 0) != (reg == 0);
+			continue;
+		}
+		if (idOfRoot[roots[i]] < 0 && rootOfId[reg] < 0)
+		{
+			idOfRoot[roots[i]] = reg;
+			rootOfId[reg] = roots[i];
+		}
+		else if (idOfRoot[roots[i]] != reg || rootOfId[reg] != roots[i])
+			mismatched++;
+	}
+
+	const bool ok = mismatched == 0 && nregions == chf->maxRegions;
+	printf("%-40s %8d spans %7d regions %7d serial %6d mismatched  %s\n", ("regions " + name).c_str(),
+		   chf->spanCount, chf->maxRegions, nregions, mismatched, ok ? "ok" : "FAILED");
+	rcFreeColumnHeightfield(chf);
+	return ok;
+}
+
+/// Rasterizes random slabs a few voxels apart over several region tiles, so that spans
+/// often reach a neighbour that connects to a different span of their own column.
+static bool checkStackedRegions()
+{
+	const int size = 300;
+	const float cs = 0.3f;
+	const float ch = 0.2f;
+	std::vector<float> verts;
+	std::vector<int> tris;
+	unsigned int rng = 7;
+	for (int i = 0; i < 1500; ++i)
+	{
+		float r[4];
+		for (int k = 0; k < 4; ++k)
+		{
+			rng = rng * 1664525u + 1013904223u;
+			r[k] = (float)(rng >> 8) / (float)(1 << 24);
+		}
+		const float x = r[0] * size * cs;
+		const float z = r[1] * size * cs;
+		const float extent = 0.5f + r[2] * 6.0f;
+		const float y = floorf(r[3] * 8.0f) * 1.0f;
+		const float q[4][3] = { { x, y, z }, { x + extent, y, z }, { x + extent, y, z + extent }, { x, y, z + extent } };
+		addQuad(verts, tris, q[0], q[3], q[2], q[1]);
+	}
+
+	const float bmin[3] = { 0, -1, 0 };
+	const float bmax[3] = { size * cs + 7, 9, size * cs + 7 };
+	const int width = (int)((bmax[0] - bmin[0]) / cs);
+	rcHeightfield* hf = rcAllocHeightfield<rcSpanLayoutCompact>();
+	if (!hf || !rcCreateHeightfield(*hf, width, width, bmin, bmax, cs, ch))
+	{
+		rcFreeHeightField(hf);
+		return false;
+	}
+	const int ntris = (int)tris.size() / 3;
+	std::vector<unsigned char> areas(ntris, RC_WALKABLE_AREA);
+	CheckContext ctx;
+	if (!rcRasterizeTriangles(&ctx, &verts[0], (int)verts.size() / 3, &tris[0], &areas[0], ntris, *hf, 1))
+	{
+		rcFreeHeightField(hf);
+		return false;
+	}
+
+	// A climb as high as the gap between slabs, so stacked spans both reach a neighbour.
+	const bool ok = checkRegions("stacked slabs", *hf, 3, 5);
+	rcFreeHeightField(hf);
+	return ok;
+}
+
+/// Rasterizes a mesh and checks its regions against the serial flood fill, with the
+/// walkable height and climb the SOP defaults to.
+template<class Layout>
+static bool checkMeshRegions(const std::string& path, const rcMeshLoaderObj& mesh, const int width, const int height,
+							 const float* bmin, const float* bmax, const CheckOptions& opts)
+{
+	rcHeightfieldT<Layout>* hf = rcAllocHeightfield<Layout>();
+	if (!hf || !rcCreateHeightfield(*hf, width, height, bmin, bmax, opts.cs, opts.ch))
+	{
+		fprintf(stderr, "RecastCheck: out of memory rasterizing %s\n", path.c_str());
+		rcFreeHeightField(hf);
+		return false;
+	}
+	std::vector<unsigned char> areas(mesh.getTriCount(), RC_WALKABLE_AREA);
+	CheckContext ctx;
+	if (!rcRasterizeTriangles(&ctx, mesh.getVerts(), mesh.getVertCount(), mesh.getTris(), &areas[0], mesh.getTriCount(), *hf, 1))
+	{
+		rcFreeHeightField(hf);
+		return false;
+	}
+	const bool ok = checkRegions(path, *hf, (int)ceilf(2.0f / opts.ch), (int)floorf(0.9f / opts.ch));
+	rcFreeHeightField(hf);
+	return ok;
+}
+
+/// Checks every triangle of a mesh on the grid the SOP would fit around it.
+static bool checkMesh(const std::string& path, const CheckOptions& opts)
+{
+	rcMeshLoaderObj mesh;
+	if (!mesh.load(path))
+	{
+		fprintf(stderr, "RecastCheck: could not read %s\n", path.c_str());
+		return false;
+	}
+	if (mesh.getTriCount() == 0)
+	{
+		fprintf(stderr, "RecastCheck: %s has no triangles, is it fetched from LFS?\n", path.c_str());
+		return false;
+	}
+
+	const float* verts = mesh.getVerts();
+	float bmin[3], bmax[3];
+	rcVcopy(bmin, verts);
+	rcVcopy(bmax, verts);
+	for (int i = 1; i < mesh.getVertCount(); ++i)
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			bmin[k] = rcMin(bmin[k], verts[i*3+k]);
+			bmax[k] = rcMax(bmax[k], verts[i*3+k]);
+		}
+	}
+
+	const int width = (int)floorf((bmax[0] - bmin[0]) / opts.cs) + 1;
+	const int height = (int)floorf((bmax[2] - bmin[2]) / opts.cs) + 1;
+	bmax[0] = bmin[0] + width * opts.cs;
+	bmax[2] = bmin[2] + height * opts.cs;
+
+	rcRasterizerCheck check = {};
+	const int spanHeight = (int)ceilf((bmax[1] - bmin[1]) / opts.ch);
+	const bool allocated = spanHeight <= rcSpanLayoutCompact::MaxHeight ?
+		rcCheckRasterizer<rcSpanLayoutCompact>(verts, mesh.getVertCount(), mesh.getTris(), mesh.getTriCount(),
+											   width, height, bmin, bmax, opts.cs, opts.ch, CHECK_TOLERANCE, check) :
+		rcCheckRasterizer<rcSpanLayoutTall>(verts, mesh.getVertCount(), mesh.getTris(), mesh.getTriCount(),
+											width, height, bmin, bmax, opts.cs, opts.ch, CHECK_TOLERANCE, check);
+	if (!allocated)
+	{
+		fprintf(stderr, "RecastCheck: out of memory checking %s\n", path.c_str());
+		return false;
+	}
+	bool ok = reportRasterizer(path.c_str(), check);
+	ok &= spanHeight <= rcSpanLayoutCompact::MaxHeight ?
+		checkMeshRegions<rcSpanLayoutCompact>(path, mesh, width, height, bmin, bmax, opts) :
+		checkMeshRegions<rcSpanLayoutTall>(path, mesh, width, height, bmin, bmax, opts);
+	return ok;
+}
+
+/// Rasterizes rolling terrain with a floor above part of it, and with @p changed a block
+/// on the floor, so a delta against the unchanged heightfield keeps most tiles.
+static rcHeightfield* buildExportHeightfield(bool changed)
+{
+	const int size = 200;
+	const float cs = 0.5f;
+	std::vector<float> verts;
+	std::vector<int> tris;
+	for (int z = 0; z < size; z += 2)
+	{
+		for (int x = 0; x < size; x += 2)
+		{
+			float q[4][3];
+			for (int i = 0; i < 4; ++i)
+			{
+				q[i][0] = (x + (i == 1 || i == 2 ? 2 : 0)) * cs;
+				q[i][2] = (z + (i >= 2 ? 2 : 0)) * cs;
+				q[i][1] = 2.0f * sinf(q[i][0] * 0.1f) * cosf(q[i][2] * 0.07f);
+			}
+			addQuad(verts, tris, q[0], q[3], q[2], q[1]);
+		}
+	}
+	const float floor[4][3] = { { 10, 6, 10 }, { 60, 6, 10 }, { 60, 6, 60 }, { 10, 6, 60 } };
+	addQuad(verts, tris, floor[0], floor[3], floor[2], floor[1]);
+	if (changed)
+	{
+		const float block[4][3] = { { 20, 8, 20 }, { 24, 8, 20 }, { 24, 8, 24 }, { 20, 8, 24 } };
+		addQuad(verts, tris, block[0], block[3], block[2], block[1]);
+	}
+
+	const float bmin[3] = { 0, -4, 0 };
+	const float bmax[3] = { size * cs, 12, size * cs };
+	rcHeightfield* hf = rcAllocHeightfield<rcSpanLayoutCompact>();
+	if (!hf || !rcCreateHeightfield(*hf, size, size, bmin, bmax, cs, 0.2f))
+	{
+		rcFreeHeightField(hf);
+		return 0;
+	}
+	const int ntris = (int)tris.size() / 3;
+	std::vector<unsigned char> areas(ntris, RC_WALKABLE_AREA);
+	for (int i = ntris - 4; i < ntris; ++i)
+		areas[i] = 7;
+	CheckContext ctx;
+	if (!rcRasterizeTriangles(&ctx, &verts[0], (int)verts.size() / 3, &tris[0], &areas[0], ntris, *hf, 1))
+	{
+		rcFreeHeightField(hf);
+		return 0;
+	}
+	return hf;
+}
+
+/// Returns true if the two heightfields hold the same spans with the same areas.
+static bool sameSpans(const rcHeightfield& a, const rcHeightfield& b)
+{
+	if (a.width != b.width || a.height != b.height)
+		return false;
+	for (int y = 0; y < a.height; ++y)
+	{
+		for (int x = 0; x < a.width; ++x)
+		{
+			const rcSpan* sa = rcGetColumn(a, x, y);
+			const rcSpan* sb = rcGetColumn(b, x, y);
+			for (; sa && sb; sa = sa->next, sb = sb->next)
+			{
+				if (sa->data.smin != sb->data.smin || sa->data.smax != sb->data.smax || sa->data.area != sb->data.area)
+					return false;
+			}
+			if (sa || sb)
+				return false;
+		}
+	}
+	return true;
+}
+
+/// Decodes an export and compares it to the heightfield it was encoded from.
+static bool decodesTo(const unsigned char* data, const int size, const unsigned char* base, const int baseSize,
+					  const rcHeightfield& expected)
+{
+	rcHeightfield* hf = rcAllocHeightfield<rcSpanLayoutCompact>();
+	rcExportHeader header;
+	const bool ok = hf && rcDecodeHeightfield(data, size, base, baseSize, *hf, header) && sameSpans(*hf, expected);
+	rcFreeHeightField(hf);
+	return ok;
+}
+
+/// Returns true if decoding the export is refused.
+static bool rejects(const unsigned char* data, const int size, const unsigned char* base, const int baseSize)
+{
+	rcHeightfield* hf = rcAllocHeightfield<rcSpanLayoutCompact>();
+	rcExportHeader header;
+	const bool decoded = hf && rcDecodeHeightfield(data, size, base, baseSize, *hf, header);
+	rcFreeHeightField(hf);
+	return !decoded;
+}
+
+/// Round trips a full and a delta export, and feeds the decoder truncated and corrupt
+/// buffers, which must be refused or at least decode without faulting.
+static bool checkExport()
+{
+	const int tileSize = 32;
+	rcHeightfield* original = buildExportHeightfield(false);
+	rcHeightfield* changed = buildExportHeightfield(true);
+	rcExportBuffer full = {}, delta = {}, changedFull = {};
+	bool ok = original && changed &&
+		rcEncodeHeightfield(*original, 0, 0, original->width, original->height, tileSize, 0, 0, full) &&
+		rcEncodeHeightfield(*changed, 0, 0, changed->width, changed->height, tileSize, full.data, full.size, delta) &&
+		rcEncodeHeightfield(*changed, 0, 0, changed->width, changed->height, tileSize, 0, 0, changedFull);
+	if (!ok)
+	{
+		fprintf(stderr, "RecastCheck: out of memory encoding the export\n");
+		rcFreeExportBuffer(full);
+		rcFreeExportBuffer(delta);
+		rcFreeExportBuffer(changedFull);
+		rcFreeHeightField(original);
+		rcFreeHeightField(changed);
+		return false;
+	}
+
+	const bool fullOk = decodesTo(full.data, full.size, 0, 0, *original);
+	const bool deltaOk = decodesTo(delta.data, delta.size, full.data, full.size, *changed) && delta.size < changedFull.size / 4;
+	// A delta only decodes against the base it was encoded from.
+	const bool wrongBaseOk = rejects(delta.data, delta.size, changedFull.data, changedFull.size) &&
+		rejects(delta.data, delta.size, 0, 0);
+
+	// Every truncation of a full export cuts into its header, index or last payload.
+	bool truncatedOk = true;
+	for (int size = 0; size < full.size; size += size < 256 ? 1 : 97)
+		truncatedOk &= rejects(full.data, size, 0, 0);
+	truncatedOk &= rejects(full.data, full.size - 1, 0, 0);
+
+	// Tile counts whose product overflows 32 bits must not size anything.
+	std::vector<unsigned char> corrupt(full.data, full.data + full.size);
+	rcExportHeader header;
+	memcpy(&header, &corrupt[0], sizeof(header));
+	header.width = header.height = 1 << 30;
+	header.tileSize = 1;
+	header.tilesX = header.tilesY = 1 << 30;
+	memcpy(&corrupt[0], &header, sizeof(header));
+	bool corruptOk = rejects(&corrupt[0], (int)corrupt.size(), 0, 0);
+
+	// Flipped payload bytes may still decode, but never out of bounds.
+	unsigned int rng = 1;
+	for (int i = 0; i < 2000; ++i)
+	{
+		corrupt.assign(full.data, full.data + full.size);
+		for (int j = 0; j < 4; ++j)
+		{
+			rng = rng * 1664525u + 1013904223u;
+			corrupt[sizeof(rcExportHeader) + (rng >> 8) % (corrupt.size() - sizeof(rcExportHeader))] ^= (unsigned char)(rng >> 24 | 1);
+		}
+		rejects(&corrupt[0], (int)corrupt.size(), 0, 0);
+	}
+
+	ok = fullOk && deltaOk && wrongBaseOk && truncatedOk && corruptOk;
+	printf("%-40s full %8d bytes  delta %6d bytes  %s%s%s%s%s\n", "export round trip", full.size, delta.size,
+		   fullOk ? "" : "full FAILED ", deltaOk ? "" : "delta FAILED ", wrongBaseOk ? "" : "wrong base FAILED ",
+		   truncatedOk ? "" : "truncated FAILED ", corruptOk ? (ok ? "ok" : "") : "corrupt FAILED");
+
+	rcFreeExportBuffer(full);
+	rcFreeExportBuffer(delta);
+	rcFreeExportBuffer(changedFull);
+	rcFreeHeightField(original);
+	rcFreeHeightField(changed);
+	return ok;
+}
+
+static void printUsage()
+{
+	printf("usage: RecastCheck [mesh.obj ...] [options]\n"
+		"  --meshes <dir>          directory of the bundled meshes, checked when no mesh is given (%s)\n"
+		"  --cs <size>             cell size of the meshes (0.3)\n"
+		"  --ch <size>             cell height of the meshes (0.2)\n"
+		"  --seeds <count>         fuzz seeds per span layout (64)\n"
+		"  --only <name>           run only the checks whose name contains this\n"
+		"Exits with 1 if any check fails.\n", RC_BUNDLED_MESHES);
+}
+
+static bool parseOptions(int argc, char** argv, CheckOptions& opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if (strcmp(arg, "--meshes") == 0 && hasValue)
+			opts.meshDir = argv[++i];
+		else if (strcmp(arg, "--cs") == 0 && hasValue)
+			opts.cs = (float)atof(argv[++i]);
+		else if (strcmp(arg, "--ch") == 0 && hasValue)
+			opts.ch = (float)atof(argv[++i]);
+		else if (strcmp(arg, "--seeds") == 0 && hasValue)
+			opts.seeds = atoi(argv[++i]);
+		else if (strcmp(arg, "--only") == 0 && hasValue)
+			opts.only = argv[++i];
+		else if (arg[0] == '-')
+		{
+			fprintf(stderr, "RecastCheck: unknown option %s\n", arg);
+			return false;
+		}
+		else
+			opts.meshes.push_back(arg);
+	}
+	return opts.cs > 0.0f && opts.ch > 0.0f && opts.seeds >= 0;
+}
+
+/// Returns true if the check is selected by --only.
+static bool selected(const CheckOptions& opts, const std::string& name)
+{
+	return opts.only.empty() || name.find(opts.only) != std::string::npos;
+}
+
+int main(int argc, char** argv)
+{
+	rcParallelSetCustom(rcParallelForThreads);
+
+	CheckOptions opts;
+	if (!parseOptions(argc, argv, opts))
+	{
+		printUsage();
+		return 1;
+	}
+
+	bool ok = true;
+	if (selected(opts, "fuzz"))
+	{
+		ok &= checkFuzz<rcSpanLayoutCompact>("compact", opts);
+		ok &= checkFuzz<rcSpanLayoutTall>("tall", opts);
+	}
+
+	if (selected(opts, "export"))
+		ok &= checkExport();
+	if (selected(opts, "regions"))
+		ok &= checkStackedRegions();
+
+	std::vector<std::string> meshes = opts.meshes;
+	if (meshes.empty() && !rcFindObjFiles(opts.meshDir, meshes))
+	{
+		fprintf(stderr, "RecastCheck: could not list the meshes in %s\n", opts.meshDir.c_str());
+		ok = false;
+	}
+	for (size_t i = 0; i < meshes.size(); ++i)
+	{
+		if (selected(opts, "mesh") || selected(opts, meshes[i]))
+			ok &= checkMesh(meshes[i], opts);
+	}
+
+	printf("%s\n", ok ? "All checks passed." : "Some checks FAILED.");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,803 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+#include "Recast.h"
+#include "RecastAlloc.h"
+#include "RecastAssert.h"
+#include "RecastMath.h"
+#include "RecastParallel.h"
+#include <stdlib.h>
+#include <string.h>
+
+/// Contours are traced in square tiles of cells, one task item per tile.
+static const int RC_CONTOUR_TILE = 64;
+
+/// Steps taken looking for the next boundary edge before a walk is given up.
+static const int RC_MAX_CONTOUR_STEPS = 40000;
+
+/// A growable array of ints that reports running out of memory, for the tile tasks.
+struct rcContourBuffer
+{
+	int* data;
+	int size;
+	int cap;
+};
+
+static bool appendInts(rcContourBuffer& buf, const int* values, const int n)
+{
+	if (buf.size + n > buf.cap)
+	{
+		int cap = rcMax(buf.cap*2, 256);
+		while (cap < buf.size + n)
+			cap *= 2;
+		int* data = (int*)rcAlloc(sizeof(int)*cap, RC_ALLOC_TEMP);
+		if (!data)
+			return false;
+		if (buf.size)
+			memcpy(data, buf.data, sizeof(int)*buf.size);
+		rcFree(buf.data);
+		buf.data = data;
+		buf.cap = cap;
+	}
+	memcpy(buf.data + buf.size, values, sizeof(int)*n);
+	buf.size += n;
+	return true;
+}
+
+/// The fields of a chain, a run of boundary edges of one tile that follow each
+/// other around a region. A chain ends where the next edge is in another tile
+/// or already starts a chain, and that edge is kept as the chain's end.
+enum rcChainField
+{
+	CHAIN_START,		///< The first edge, as span*4 + direction.
+	CHAIN_END,			///< The edge after the last one, as span*4 + direction, or -1 if the walk broke off.
+	CHAIN_FIRST_VERT,	///< The vertex of the first edge in the tile's vertices.
+	CHAIN_VERTS,		///< The number of edges.
+	CHAIN_REG,
+	CHAIN_AREA,
+	CHAIN_TILE,
+	CHAIN_SIZE,
+};
+
+/// The chains traced in one tile.
+struct rcContourTile
+{
+	rcContourBuffer verts;		///< One (x, y, z, flags) vertex per boundary edge.
+	rcContourBuffer chains;		///< #CHAIN_SIZE ints per chain.
+	bool failed;
+};
+
+/// Tracing runs one task item per tile, or per row of cells.
+struct rcContourTask
+{
+	const rcColumnHeightfield* chf;
+	unsigned char* flags;		///< The boundary edges of every span, a bit per direction.
+	unsigned char* remaining;	///< The boundary edges not traced yet, written by the tile of the span only.
+	rcContourTile* tiles;
+	int tilesX;
+};
+
+/// Marks the edges of the spans of the rows [begin, end) that do not lead into the same region.
+static void markBoundaryEdges(void* userData, int begin, int end)
+{
+	const rcContourTask& task = *(const rcContourTask*)userData;
+	const rcColumnHeightfield& chf = *task.chf;
+	for (int y = begin; y < end; ++y)
+	{
+		for (int x = 0; x < chf.width; ++x)
+		{
+			const int c = x + y*chf.width;
+			for (unsigned int i = chf.cells[c]; i < chf.cells[c + 1]; ++i)
+			{
+				unsigned char res = 0;
+				if (chf.regs[i] != 0)
+				{
+					for (int dir = 0; dir < 4; ++dir)
+					{
+						const int ni = rcGetColumnNeighbour(chf, x, y, i, dir);
+						if (ni < 0 || chf.regs[ni] != chf.regs[i])
+							res |= (unsigned char)(1 << dir);
+					}
+				}
+				task.flags[i] = res;
+				task.remaining[i] = res;
+			}
+		}
+	}
+}
+
+/// Returns the height of the corner at the end of edge @p dir of span @p i,
+/// the highest floor of the spans around it.
+static int getCornerHeight(const rcColumnHeightfield& chf, int x, int y, unsigned int i, int dir)
+{
+	int h = chf.smax[i];
+	const int dirp = (dir + 1) & 0x3;
+
+	const int ai = rcGetColumnNeighbour(chf, x, y, i, dir);
+	if (ai >= 0)
+	{
+		h = rcMax(h, (int)chf.smax[ai]);
+		const int bi = rcGetColumnNeighbour(chf, x + rcGetDirOffsetX(dir), y + rcGetDirOffsetY(dir), (unsigned int)ai, dirp);
+		if (bi >= 0)
+			h = rcMax(h, (int)chf.smax[bi]);
+	}
+	const int ci = rcGetColumnNeighbour(chf, x, y, i, dirp);
+	if (ci >= 0)
+	{
+		h = rcMax(h, (int)chf.smax[ci]);
+		const int di = rcGetColumnNeighbour(chf, x + rcGetDirOffsetX(dirp), y + rcGetDirOffsetY(dirp), (unsigned int)ci, dir);
+		if (di >= 0)
+			h = rcMax(h, (int)chf.smax[di]);
+	}
+	return h;
+}
+
+/// Traces the chains starting from the untraced edges of one tile.
+static void traceTiles(void* userData, int begin, int end)
+{
+	const rcContourTask& task = *(const rcContourTask*)userData;
+	const rcColumnHeightfield& chf = *task.chf;
+	for (int t = begin; t < end; ++t)
+	{
+		rcContourTile& tile = task.tiles[t];
+		const int x0 = (t % task.tilesX)*RC_CONTOUR_TILE;
+		const int y0 = (t / task.tilesX)*RC_CONTOUR_TILE;
+		const int x1 = rcMin(x0 + RC_CONTOUR_TILE, chf.width);
+		const int y1 = rcMin(y0 + RC_CONTOUR_TILE, chf.height);
+		for (int sy = y0; sy < y1 && !tile.failed; ++sy)
+		{
+			for (int sx = x0; sx < x1 && !tile.failed; ++sx)
+			{
+				const int c = sx + sy*chf.width;
+				for (unsigned int si = chf.cells[c]; si < chf.cells[c + 1] && !tile.failed; ++si)
+				{
+					while (task.remaining[si] && !tile.failed)
+					{
+						int x = sx;
+						int y = sy;
+						unsigned int i = si;
+						int dir = rcLowestBit(task.remaining[si]);
+						int chain[CHAIN_SIZE];
+						chain[CHAIN_START] = (int)(i*4 + dir);
+						chain[CHAIN_END] = -1;
+						chain[CHAIN_FIRST_VERT] = tile.verts.size / 4;
+						chain[CHAIN_VERTS] = 0;
+						chain[CHAIN_REG] = chf.regs[i];
+						chain[CHAIN_AREA] = chf.areas[i];
+						chain[CHAIN_TILE] = t;
+
+						for (;;)
+						{
+							// The vertex at the end of the edge, with the region across it.
+							int v[4] = { x, getCornerHeight(chf, x, y, i, dir), y, 0 };
+							if (dir == 0)
+								v[2]++;
+							else if (dir == 1)
+							{
+								v[0]++;
+								v[2]++;
+							}
+							else if (dir == 2)
+								v[0]++;
+							const int ai = rcGetColumnNeighbour(chf, x, y, i, dir);
+							if (ai >= 0 && chf.regs[ai] != 0)
+							{
+								v[3] = chf.regs[ai];
+								if (chf.areas[ai] != chf.areas[i])
+									v[3] |= RC_AREA_BORDER;
+							}
+							if (!appendInts(tile.verts, v, 4))
+							{
+								tile.failed = true;
+								break;
+							}
+							chain[CHAIN_VERTS]++;
+							task.remaining[i] &= (unsigned char)~(1 << dir);
+
+							// Turn clockwise around the region to the next boundary edge.
+							int d = (dir + 1) & 0x3;
+							int steps = 0;
+							while (!(task.flags[i] & (1 << d)) && steps++ < RC_MAX_CONTOUR_STEPS)
+							{
+								const int ni = rcGetColumnNeighbour(chf, x, y, i, d);
+								if (ni < 0)
+								{
+									steps = RC_MAX_CONTOUR_STEPS + 1;
+									break;
+								}
+								x += rcGetDirOffsetX(d);
+								y += rcGetDirOffsetY(d);
+								i = (unsigned int)ni;
+								d = (d + 3) & 0x3;
+							}
+							if (steps > RC_MAX_CONTOUR_STEPS)
+								break;
+
+							dir = d;
+							if (x < x0 || y < y0 || x >= x1 || y >= y1 || !(task.remaining[i] & (1 << dir)))
+							{
+								chain[CHAIN_END] = (int)(i*4 + dir);
+								break;
+							}
+						}
+						if (!tile.failed && !appendInts(tile.chains, chain, CHAIN_SIZE))
+							tile.failed = true;
+					}
+				}
+			}
+		}
+	}
+}
+
+static float distancePtSeg(const int x, const int z,
+						   const int px, const int pz,
+						   const int qx, const int qz)
+{
+	float pqx = (float)(qx - px);
+	float pqz = (float)(qz - pz);
+	float dx = (float)(x - px);
+	float dz = (float)(z - pz);
+	float d = pqx*pqx + pqz*pqz;
+	float t = pqx*dx + pqz*dz;
+	if (d > 0)
+		t /= d;
+	if (t < 0)
+		t = 0;
+	else if (t > 1)
+		t = 1;
+
+	dx = px + t*pqx - x;
+	dz = pz + t*pqz - z;
+
+	return dx*dx + dz*dz;
+}
+
+/// Inserts the raw point @p maxi after simplified point @p i.
+static void insertPoint(rcIntArray& simplified, const rcIntArray& points, const int i, const int maxi)
+{
+	simplified.resize(simplified.size() + 4);
+	const int n = simplified.size() / 4;
+	for (int j = n - 1; j > i; --j)
+	{
+		simplified[j*4+0] = simplified[(j-1)*4+0];
+		simplified[j*4+1] = simplified[(j-1)*4+1];
+		simplified[j*4+2] = simplified[(j-1)*4+2];
+		simplified[j*4+3] = simplified[(j-1)*4+3];
+	}
+	simplified[(i+1)*4+0] = points[maxi*4+0];
+	simplified[(i+1)*4+1] = points[maxi*4+1];
+	simplified[(i+1)*4+2] = points[maxi*4+2];
+	simplified[(i+1)*4+3] = maxi;
+}
+
+/// Simplifies the raw contour @p points as Recast does: the points where the region
+/// across the edge changes are kept, then the points furthest from the simplified
+/// walls and area borders are added back until none is further than @p maxError.
+static void simplifyContour(const rcIntArray& points, rcIntArray& simplified, const float maxError, const int maxEdgeLen)
+{
+	const int pn = points.size() / 4;
+
+	// Add a point wherever the region or area across the edge changes.
+	for (int i = 0; i < pn; ++i)
+	{
+		const int ii = (i+1) % pn;
+		const bool differentRegs = (points[i*4+3] & RC_CONTOUR_REG_MASK) != (points[ii*4+3] & RC_CONTOUR_REG_MASK);
+		const bool areaBorders = (points[i*4+3] & RC_AREA_BORDER) != (points[ii*4+3] & RC_AREA_BORDER);
+		if (differentRegs || areaBorders)
+		{
+			simplified.push(points[i*4+0]);
+			simplified.push(points[i*4+1]);
+			simplified.push(points[i*4+2]);
+			simplified.push(i);
+		}
+	}
+
+	if (simplified.size() == 0)
+	{
+		// If there is no connections at all,
+		// create some initial points for the simplification process. 
+		// Find lower-left and upper-right vertices of the contour.
+		int llx = points[0];
+		int lly = points[1];
+		int llz = points[2];
+		int lli = 0;
+		int urx = points[0];
+		int ury = points[1];
+		int urz = points[2];
+		int uri = 0;
+		for (int i = 0; i < pn; ++i)
+		{
+			const int x = points[i*4+0];
+			const int y = points[i*4+1];
+			const int z = points[i*4+2];
+			if (x < llx || (x == llx && z < llz))
+			{
+				llx = x;
+				lly = y;
+				llz = z;
+				lli = i;
+			}
+			if (x > urx || (x == urx && z > urz))
+			{
+				urx = x;
+				ury = y;
+				urz = z;
+				uri = i;
+			}
+		}
+		simplified.push(llx);
+		simplified.push(lly);
+		simplified.push(llz);
+		simplified.push(lli);
+
+		simplified.push(urx);
+		simplified.push(ury);
+		simplified.push(urz);
+		simplified.push(uri);
+	}
+
+	// Add points until all raw points are within
+	// error tolerance to the simplified shape.
+	for (int i = 0; i < simplified.size()/4; )
+	{
+		const int ii = (i+1) % (simplified.size()/4);
+
+		int ax = simplified[i*4+0];
+		int az = simplified[i*4+2];
+		const int ai = simplified[i*4+3];
+
+		int bx = simplified[ii*4+0];
+		int bz = simplified[ii*4+2];
+		const int bi = simplified[ii*4+3];
+
+		// Find maximum deviation from the segment.
+		float maxd = 0;
+		int maxi = -1;
+		int ci, cinc, endi;
+
+		// Traverse the segment in lexilogical order so that the
+		// max deviation is calculated similarly when traversing
+		// opposite segments.
+		if (bx > ax || (bx == ax && bz > az))
+		{
+			cinc = 1;
+			ci = (ai+cinc) % pn;
+			endi = bi;
+		}
+		else
+		{
+			cinc = pn-1;
+			ci = (bi+cinc) % pn;
+			endi = ai;
+			rcSwap(ax, bx);
+			rcSwap(az, bz);
+		}
+
+		// Tessellate only outer edges or edges between areas.
+		if ((points[ci*4+3] & RC_CONTOUR_REG_MASK) == 0 ||
+			(points[ci*4+3] & RC_AREA_BORDER))
+		{
+			while (ci != endi)
+			{
+				const float d = distancePtSeg(points[ci*4+0], points[ci*4+2], ax, az, bx, bz);
+				if (d > maxd)
+				{
+					maxd = d;
+					maxi = ci;
+				}
+				ci = (ci+cinc) % pn;
+			}
+		}
+
+		// If the max deviation is larger than accepted error,
+		// add new point, else continue to next segment.
+		if (maxi != -1 && maxd > (maxError*maxError))
+			insertPoint(simplified, points, i, maxi);
+		else
+			++i;
+	}
+
+	// Split too long edges.
+	if (maxEdgeLen > 0)
+	{
+		for (int i = 0; i < simplified.size()/4; )
+		{
+			const int ii = (i+1) % (simplified.size()/4);
+
+			const int ax = simplified[i*4+0];
+			const int az = simplified[i*4+2];
+			const int ai = simplified[i*4+3];
+
+			const int bx = simplified[ii*4+0];
+			const int bz = simplified[ii*4+2];
+			const int bi = simplified[ii*4+3];
+
+			// Find maximum deviation from the segment.
+			int maxi = -1;
+			const int ci = (ai+1) % pn;
+
+			// Tessellate only outer edges or edges between areas.
+			if ((points[ci*4+3] & RC_CONTOUR_REG_MASK) == 0 ||
+				(points[ci*4+3] & RC_AREA_BORDER))
+			{
+				const int dx = bx - ax;
+				const int dz = bz - az;
+				if (dx*dx + dz*dz > maxEdgeLen*maxEdgeLen)
+				{
+					// Round based on the segments in lexilogical order so that the
+					// max tesselation is consistent regardles in which direction
+					// segments are traversed.
+					const int n = bi < ai ? (bi+pn - ai) : (bi - ai);
+					if (n > 1)
+					{
+						if (bx > ax || (bx == ax && bz > az))
+							maxi = (ai + n/2) % pn;
+						else
+							maxi = (ai + (n+1)/2) % pn;
+					}
+				}
+			}
+
+			// If the max deviation is larger than accepted error,
+			// add new point, else continue to next segment.
+			if (maxi != -1)
+				insertPoint(simplified, points, i, maxi);
+			else
+				++i;
+		}
+	}
+
+	for (int i = 0; i < simplified.size()/4; ++i)
+	{
+		// The edge vertex flag is take from the current raw point,
+		// and the neighbour region is take from the next raw point.
+		const int ai = (simplified[i*4+3]+1) % pn;
+		simplified[i*4+3] = points[ai*4+3] & (RC_CONTOUR_REG_MASK|RC_AREA_BORDER);
+	}
+}
+
+static void removeDegenerateSegments(rcIntArray& simplified)
+{
+	// Remove adjacent vertices which are equal on xz-plane,
+	// or else the triangulator will get confused.
+	int npts = simplified.size()/4;
+	for (int i = 0; i < npts; ++i)
+	{
+		const int ni = (i+1) % npts;
+
+		if (simplified[i*4+0] == simplified[ni*4+0] && simplified[i*4+2] == simplified[ni*4+2])
+		{
+			// Degenerate segment, remove.
+			for (int j = i; j < simplified.size()/4-1; ++j)
+			{
+				simplified[j*4+0] = simplified[(j+1)*4+0];
+				simplified[j*4+1] = simplified[(j+1)*4+1];
+				simplified[j*4+2] = simplified[(j+1)*4+2];
+				simplified[j*4+3] = simplified[(j+1)*4+3];
+			}
+			simplified.resize(simplified.size()-4);
+			npts--;
+		}
+	}
+}
+
+/// Simplifying runs one task item per contour.
+struct rcSimplifyTask
+{
+	rcContour* conts;
+	float maxError;
+	int maxEdgeLen;
+};
+
+static void simplifyContours(void* userData, int begin, int end)
+{
+	const rcSimplifyTask& task = *(const rcSimplifyTask*)userData;
+	rcIntArray points;
+	rcIntArray simplified;
+	for (int c = begin; c < end; ++c)
+	{
+		rcContour& cont = task.conts[c];
+		points.resize(cont.nrverts*4);
+		memcpy(&points[0], cont.rverts, sizeof(int)*4*cont.nrverts);
+		simplified.resize(0);
+		simplifyContour(points, simplified, task.maxError, task.maxEdgeLen);
+		removeDegenerateSegments(simplified);
+
+		cont.nverts = simplified.size()/4;
+		cont.verts = (int*)rcAlloc(sizeof(int)*rcMax(simplified.size(), 1), RC_ALLOC_PERM);
+		if (!cont.verts)
+		{
+			// Flags the contour set as out of memory.
+			cont.nverts = -1;
+			continue;
+		}
+		if (cont.nverts > 0)
+			memcpy(cont.verts, &simplified[0], sizeof(int)*cont.nverts*4);
+	}
+}
+
+/// Orders chains by their first edge.
+static int compareChainStart(const void* va, const void* vb)
+{
+	const int a = *(const int*)va;
+	const int b = *(const int*)vb;
+	return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+/// Returns the chain starting at @p key, or -1 if there is none.
+static int findChain(const int* starts, const int nchains, const int key)
+{
+	int lo = 0;
+	int hi = nchains - 1;
+	while (lo <= hi)
+	{
+		const int mid = (lo + hi) / 2;
+		if (starts[mid*2] < key)
+			lo = mid + 1;
+		else if (starts[mid*2] > key)
+			hi = mid - 1;
+		else
+			return starts[mid*2+1];
+	}
+	return -1;
+}
+
+static void freeContours(rcContourSet& cset)
+{
+	for (int i = 0; i < cset.nconts; ++i)
+	{
+		rcFree(cset.conts[i].verts);
+		rcFree(cset.conts[i].rverts);
+	}
+	rcFree(cset.conts);
+	cset.conts = 0;
+	cset.nconts = 0;
+}
+
+rcContourSet* rcAllocContourSet()
+{
+	rcContourSet* cset = (rcContourSet*)rcAlloc(sizeof(rcContourSet), RC_ALLOC_PERM);
+	if (cset)
+		memset(cset, 0, sizeof(rcContourSet));
+	return cset;
+}
+
+void rcFreeContourSet(rcContourSet* cset)
+{
+	if (!cset)
+		return;
+	freeContours(*cset);
+	rcFree(cset);
+}
+
+/// Frees the tile buffers of a contour build.
+static void freeContourTiles(rcContourTile* tiles, const int ntiles)
+{
+	for (int t = 0; t < ntiles; ++t)
+	{
+		rcFree(tiles[t].verts.data);
+		rcFree(tiles[t].chains.data);
+	}
+	rcFree(tiles);
+}
+
+/// @par
+///
+/// The boundary edges of every region are found in parallel over rows, and each
+/// tile then walks its own edges in parallel into chains that stop at the tile
+/// border. The chains are stitched across the tile borders into closed raw
+/// contours, one vertex per cell edge, which are simplified in parallel.
+/// Contours that simplify to fewer than 3 vertices are dropped. Loops whose walk
+/// broke off are dropped too, and reported as a warning through @p ctx.
+///
+/// @see rcBuildColumnRegions, rcContourSet
+bool rcBuildContours(rcContext* ctx, const rcColumnHeightfield& chf, const float maxError, const int maxEdgeLen, rcContourSet& cset)
+{
+	rcAssert(ctx);
+	rcAssert(chf.regs);
+
+	freeContours(cset);
+	rcVcopy(cset.bmin, chf.bmin);
+	rcVcopy(cset.bmax, chf.bmax);
+	cset.cs = chf.cs;
+	cset.ch = chf.ch;
+	cset.width = chf.width;
+	cset.height = chf.height;
+	cset.maxError = maxError;
+
+	rcContourTask task;
+	task.chf = &chf;
+	task.tilesX = (chf.width + RC_CONTOUR_TILE - 1) / RC_CONTOUR_TILE;
+	const int ntiles = task.tilesX*((chf.height + RC_CONTOUR_TILE - 1) / RC_CONTOUR_TILE);
+
+	rcScopedDelete<unsigned char> flags(chf.spanCount + 1);
+	rcScopedDelete<unsigned char> remaining(chf.spanCount + 1);
+	task.tiles = (rcContourTile*)rcAlloc(sizeof(rcContourTile)*rcMax(ntiles, 1), RC_ALLOC_TEMP);
+	if (!flags || !remaining || !task.tiles)
+	{
+		ctx->log(RC_LOG_ERROR, "rcBuildContours: Out of memory 'flags' (%d).", chf.spanCount + 1);
+		rcFree(task.tiles);
+		return false;
+	}
+	memset(task.tiles, 0, sizeof(rcContourTile)*ntiles);
+	task.flags = flags;
+	task.remaining = remaining;
+
+	rcParallelFor(chf.height, RC_BRICK_SIZE, markBoundaryEdges, &task);
+	rcParallelFor(ntiles, 1, traceTiles, &task);
+
+	// The chains of all tiles, sorted by their first edge for the stitching.
+	int nchains = 0;
+	bool failed = false;
+	for (int t = 0; t < ntiles; ++t)
+	{
+		nchains += task.tiles[t].chains.size / CHAIN_SIZE;
+		failed = failed || task.tiles[t].failed;
+	}
+	rcScopedDelete<int> chains(rcMax(nchains, 1)*2);
+	rcScopedDelete<int> starts(rcMax(nchains, 1)*2);
+	rcScopedDelete<unsigned char> used(rcMax(nchains, 1));
+	if (failed || !chains || !starts || !used)
+	{
+		ctx->log(RC_LOG_ERROR, "rcBuildContours: Out of memory tracing %d chains.", nchains);
+		freeContourTiles(task.tiles, ntiles);
+		return false;
+	}
+	int n = 0;
+	for (int t = 0; t < ntiles; ++t)
+	{
+		const rcContourBuffer& tileChains = task.tiles[t].chains;
+		for (int j = 0; j < tileChains.size; j += CHAIN_SIZE, ++n)
+		{
+			chains[n*2+0] = t;
+			chains[n*2+1] = j;
+			starts[n*2+0] = tileChains.data[j + CHAIN_START];
+			starts[n*2+1] = n;
+		}
+	}
+	qsort(starts, nchains, sizeof(int)*2, compareChainStart);
+	memset(used, 0, nchains);
+
+	// Follow the chains from tile to tile until they come back around. A loop
+	// with a broken walk in it is dropped.
+	rcIntArray loops;
+	int nbroken = 0;
+	int brokenReg = 0;
+	for (int first = 0; first < nchains; ++first)
+	{
+		if (used[first])
+			continue;
+		int nverts = 0;
+		int cur = first;
+		bool closed = true;
+		do
+		{
+			if (used[cur])
+			{
+				closed = false;
+				break;
+			}
+			used[cur] = 1;
+			const int* chain = &task.tiles[chains[cur*2]].chains.data[chains[cur*2+1]];
+			nverts += chain[CHAIN_VERTS];
+			cur = chain[CHAIN_END] >= 0 ? findChain(starts, nchains, chain[CHAIN_END]) : -1;
+			if (cur < 0)
+			{
+				closed = false;
+				break;
+			}
+		}
+		while (cur != first);
+		if (closed)
+		{
+			loops.push(first);
+			loops.push(nverts);
+		}
+		else if (nbroken++ == 0)
+		{
+			brokenReg = task.tiles[chains[first*2]].chains.data[chains[first*2+1] + CHAIN_REG];
+		}
+	}
+	if (nbroken)
+	{
+		ctx->log(RC_LOG_WARNING, "rcBuildContours: Dropped %d broken contour loops, the first of region %d. "
+			"The regions may be too complex to walk.", nbroken, brokenReg);
+	}
+
+	const int nloops = loops.size() / 2;
+	cset.conts = (rcContour*)rcAlloc(sizeof(rcContour)*rcMax(nloops, 1), RC_ALLOC_PERM);
+	if (!cset.conts)
+	{
+		ctx->log(RC_LOG_ERROR, "rcBuildContours: Out of memory 'conts' (%d).", nloops);
+		freeContourTiles(task.tiles, ntiles);
+		return false;
+	}
+	memset(cset.conts, 0, sizeof(rcContour)*nloops);
+	cset.nconts = nloops;
+	for (int l = 0; l < nloops; ++l)
+	{
+		rcContour& cont = cset.conts[l];
+		cont.nrverts = loops[l*2+1];
+		cont.rverts = (int*)rcAlloc(sizeof(int)*4*cont.nrverts, RC_ALLOC_PERM);
+		if (!cont.rverts)
+		{
+			ctx->log(RC_LOG_ERROR, "rcBuildContours: Out of memory 'rverts' (%d).", cont.nrverts);
+			freeContourTiles(task.tiles, ntiles);
+			freeContours(cset);
+			return false;
+		}
+
+		int nverts = 0;
+		int cur = loops[l*2];
+		do
+		{
+			const rcContourTile& tile = task.tiles[chains[cur*2]];
+			const int* chain = &tile.chains.data[chains[cur*2+1]];
+			memcpy(&cont.rverts[nverts*4], &tile.verts.data[chain[CHAIN_FIRST_VERT]*4], sizeof(int)*4*chain[CHAIN_VERTS]);
+			nverts += chain[CHAIN_VERTS];
+			cont.reg = (unsigned short)chain[CHAIN_REG];
+			cont.area = (unsigned char)chain[CHAIN_AREA];
+			cur = findChain(starts, nchains, chain[CHAIN_END]);
+		}
+		while (cur != loops[l*2]);
+	}
+	freeContourTiles(task.tiles, ntiles);
+
+	rcSimplifyTask simplify = { cset.conts, maxError, maxEdgeLen };
+	rcParallelFor(cset.nconts, 16, simplifyContours, &simplify);
+
+	// Drop the contours that collapsed.
+	int nconts = 0;
+	for (int i = 0; i < cset.nconts; ++i)
+	{
+		rcContour& cont = cset.conts[i];
+		failed = failed || cont.nverts < 0;
+		if (cont.nverts < 3)
+		{
+			rcFree(cont.verts);
+			rcFree(cont.rverts);
+			continue;
+		}
+		cset.conts[nconts++] = cont;
+	}
+	cset.nconts = nconts;
+	if (failed)
+	{
+		ctx->log(RC_LOG_ERROR, "rcBuildContours: Out of memory simplifying the contours.");
+		freeContours(cset);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,649 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+
+#include <string.h>
+
+#include "RecastExport.h"
+#include "RecastMath.h"
+#include "RecastAlloc.h"
+#include "RecastParallel.h"
+
+static const int RC_EXPORT_MAX_VARINT = 5;
+
+static inline unsigned char* writeVarint(unsigned char* p, unsigned int v)
+{
+	while (v >= 0x80)
+	{
+		*p++ = (unsigned char)(v | 0x80);
+		v >>= 7;
+	}
+	*p++ = (unsigned char)v;
+	return p;
+}
+
+/// Returns null if the varint runs past @p end.
+static inline const unsigned char* readVarint(const unsigned char* p, const unsigned char* end, unsigned int& v)
+{
+	// Most values are a single byte.
+	if (p < end && *p < 0x80)
+	{
+		v = *p;
+		return p + 1;
+	}
+	v = 0;
+	for (int shift = 0; shift < 7*RC_EXPORT_MAX_VARINT; shift += 7)
+	{
+		if (p >= end)
+			return 0;
+		const unsigned int b = *p++;
+		v |= (b & 0x7f) << shift;
+		if (b < 0x80)
+			return p;
+	}
+	return 0;
+}
+
+static inline unsigned int zigzag(int v)
+{
+	return ((unsigned int)v << 1) ^ (unsigned int)(v >> 31);
+}
+
+static inline int unzigzag(unsigned int v)
+{
+	return (int)(v >> 1) ^ -(int)(v & 1);
+}
+
+/// FNV-1a over the bytes of an export, to tie a delta to its base.
+static unsigned long long hashExport(const unsigned char* data, const int size)
+{
+	unsigned long long h = 14695981039346656037ull;
+	for (int i = 0; i < size; ++i)
+	{
+		h ^= data[i];
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+/// An export split in its header, index and payloads, checked against its size.
+struct rcExportView
+{
+	rcExportHeader header;
+	const rcExportTile* tiles;
+	const unsigned char* payload;
+	unsigned int payloadSize;
+};
+
+static bool readView(const unsigned char* data, const int size, rcExportView& view)
+{
+	if (!rcReadExportHeader(data, size, view.header))
+		return false;
+	// The tile counts come from the file, so the index size is computed in 64 bits
+	// and checked against the buffer before anything is sized from it.
+	if (view.header.tilesX <= 0 || view.header.tilesY <= 0)
+		return false;
+	const unsigned long long ntiles = (unsigned long long)view.header.tilesX * (unsigned long long)view.header.tilesY;
+	const unsigned long long indexEnd = sizeof(rcExportHeader) + sizeof(rcExportTile)*ntiles;
+	if (indexEnd > (unsigned long long)size)
+		return false;
+	view.tiles = (const rcExportTile*)(data + sizeof(rcExportHeader));
+	view.payload = data + (size_t)indexEnd;
+	view.payloadSize = (unsigned int)((unsigned long long)size - indexEnd);
+	return true;
+}
+
+/// A tile encoded on its own, concatenated into the export once all tiles are done.
+struct rcExportTileData
+{
+	unsigned char* data;
+	int size;
+	int spanCount;
+	bool failed;
+};
+
+template<class Layout>
+struct rcExportTask
+{
+	const rcHeightfieldT<Layout>* hf;
+	int x0, y0;
+	int width, height;
+	int tileSize;
+	int tilesX;
+	rcExportTileData* tiles;
+};
+
+/// Appends a run of @p length copies of @p value to an RLE section.
+static inline unsigned char* writeRun(unsigned char* p, const unsigned int length, const unsigned int value, const bool byteValue)
+{
+	p = writeVarint(p, length);
+	if (byteValue)
+		*p++ = (unsigned char)value;
+	else
+		p = writeVarint(p, value);
+	return p;
+}
+
+/// The area run being written to the areas section of a tile.
+struct rcExportAreaRuns
+{
+	unsigned int length;
+	unsigned int value;
+};
+
+template<class Layout>
+static bool sameSpans(const rcSpanT<Layout>* a, const rcSpanT<Layout>* b)
+{
+	for (; a && b; a = a->next, b = b->next)
+	{
+		if (a->data.smin != b->data.smin || a->data.smax != b->data.smax || a->data.area != b->data.area)
+			return false;
+	}
+	return !a && !b;
+}
+
+/// Writes the heights and areas of a column, returns false if its spans are not sorted and apart.
+template<class Layout>
+static bool encodeColumn(const rcSpanT<Layout>* column, int& prevFirst, unsigned char*& ph, unsigned char*& pa,
+						 rcExportAreaRuns& areaRuns)
+{
+	int prevTop = -1;
+	for (const rcSpanT<Layout>* s = column; s; s = s->next)
+	{
+		const int smin = (int)s->data.smin;
+		const int smax = (int)s->data.smax;
+		// The gaps are stored minus one, which needs sorted, apart spans.
+		if (smin <= prevTop || smax < smin)
+			return false;
+		if (prevTop < 0)
+		{
+			ph = writeVarint(ph, zigzag(smin - prevFirst));
+			prevFirst = smin;
+		}
+		else
+			ph = writeVarint(ph, (unsigned int)(smin - prevTop - 1));
+		ph = writeVarint(ph, (unsigned int)(smax - smin));
+		prevTop = smax;
+
+		const unsigned int area = s->data.area;
+		if (areaRuns.length && area == areaRuns.value)
+			areaRuns.length++;
+		else
+		{
+			if (areaRuns.length)
+				pa = writeRun(pa, areaRuns.length, areaRuns.value, true);
+			areaRuns.value = area;
+			areaRuns.length = 1;
+		}
+	}
+	return true;
+}
+
+template<class Layout>
+static bool encodeTile(const rcExportTask<Layout>& task, const int tx, const int ty, rcExportTileData& tile)
+{
+	const rcHeightfieldT<Layout>& hf = *task.hf;
+	const int cx0 = task.x0 + tx*task.tileSize;
+	const int cy0 = task.y0 + ty*task.tileSize;
+	const int cx1 = task.x0 + rcMin((tx + 1)*task.tileSize, task.width);
+	const int cy1 = task.y0 + rcMin((ty + 1)*task.tileSize, task.height);
+
+	int ncolumns = 0;
+	int nspans = 0;
+	for (int y = cy0; y < cy1; ++y)
+	{
+		for (int x = cx0; x < cx1; ++x)
+		{
+			for (const rcSpanT<Layout>* s = rcGetColumn(hf, x, y); s; s = s->next)
+				nspans++;
+			ncolumns++;
+		}
+	}
+	tile.spanCount = nspans;
+	if (!nspans)
+		return true;
+
+	// Every run and span fits the worst case of its varints.
+	const int countsCap = ncolumns*2*RC_EXPORT_MAX_VARINT;
+	const int heightsCap = nspans*2*RC_EXPORT_MAX_VARINT;
+	const int areasCap = nspans*(RC_EXPORT_MAX_VARINT + 1);
+	unsigned char* scratch = (unsigned char*)rcAlloc(countsCap + heightsCap + areasCap, RC_ALLOC_TEMP);
+	if (!scratch)
+		return false;
+	unsigned char* counts = scratch;
+	unsigned char* heights = counts + countsCap;
+	unsigned char* areas = heights + heightsCap;
+	unsigned char* pc = counts;
+	unsigned char* ph = heights;
+	unsigned char* pa = areas;
+
+	bool ok = true;
+	unsigned int countRun = 0, countValue = 0;
+	rcExportAreaRuns areaRuns = { 0, 0 };
+	int prevFirst = 0;
+	const rcSpanT<Layout>* prevColumn = 0;
+	for (int y = cy0; y < cy1 && ok; ++y)
+	{
+		for (int x = cx0; x < cx1 && ok; ++x)
+		{
+			const rcSpanT<Layout>* column = rcGetColumn(hf, x, y);
+			unsigned int count = 0;
+			for (const rcSpanT<Layout>* s = column; s; s = s->next)
+				count++;
+
+			// A column repeating the previous one, as in flat areas, only costs its token.
+			unsigned int token = count << 1;
+			if (count && sameSpans(column, prevColumn))
+				token |= 1;
+			else if (count)
+			{
+				ok = encodeColumn(column, prevFirst, ph, pa, areaRuns);
+				prevColumn = column;
+			}
+
+			if (countRun && token == countValue)
+				countRun++;
+			else
+			{
+				if (countRun)
+					pc = writeRun(pc, countRun, countValue, false);
+				countValue = token;
+				countRun = 1;
+			}
+		}
+	}
+	if (ok)
+	{
+		pc = writeRun(pc, countRun, countValue, false);
+		pa = writeRun(pa, areaRuns.length, areaRuns.value, true);
+
+		const int countsSize = (int)(pc - counts);
+		const int heightsSize = (int)(ph - heights);
+		const int areasSize = (int)(pa - areas);
+		tile.data = (unsigned char*)rcAlloc(2*RC_EXPORT_MAX_VARINT + countsSize + heightsSize + areasSize, RC_ALLOC_TEMP);
+		ok = tile.data != 0;
+		if (ok)
+		{
+			unsigned char* p = tile.data;
+			p = writeVarint(p, (unsigned int)countsSize);
+			p = writeVarint(p, (unsigned int)heightsSize);
+			memcpy(p, counts, countsSize);
+			p += countsSize;
+			memcpy(p, heights, heightsSize);
+			p += heightsSize;
+			memcpy(p, areas, areasSize);
+			p += areasSize;
+			tile.size = (int)(p - tile.data);
+		}
+	}
+
+	rcFree(scratch);
+	return ok;
+}
+
+template<class Layout>
+static void encodeTiles(void* userData, int begin, int end)
+{
+	const rcExportTask<Layout>& task = *(const rcExportTask<Layout>*)userData;
+	for (int i = begin; i < end; ++i)
+	{
+		rcExportTileData& tile = task.tiles[i];
+		tile.failed = !encodeTile(task, i % task.tilesX, i / task.tilesX, tile);
+	}
+}
+
+/// @par
+///
+/// Tiles are encoded into their own buffers in parallel, then copied after the index
+/// in row major order. A delta export keeps the full header and index, so any tile can
+/// still be looked up directly, and unchanged tiles are read from the base.
+///
+/// @see rcDecodeHeightfield, rcDecodeExportTile
+template<class Layout>
+bool rcEncodeHeightfield(const rcHeightfieldT<Layout>& hf, const int x0, const int y0,
+						 const int width, const int height, const int tileSize,
+						 const unsigned char* base, const int baseSize, rcExportBuffer& out)
+{
+	out.data = 0;
+	out.size = 0;
+	if (x0 < 0 || y0 < 0 || width <= 0 || height <= 0 || x0 + width > hf.width || y0 + height > hf.height || tileSize <= 0)
+		return false;
+
+	rcExportHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = RC_EXPORT_MAGIC;
+	header.version = RC_EXPORT_VERSION;
+	header.heightBits = Layout::HeightBits;
+	header.width = width;
+	header.height = height;
+	header.tileSize = tileSize;
+	header.tilesX = (width + tileSize - 1) / tileSize;
+	header.tilesY = (height + tileSize - 1) / tileSize;
+	header.bmin[0] = hf.bmin[0] + x0*hf.cs;
+	header.bmin[1] = hf.bmin[1];
+	header.bmin[2] = hf.bmin[2] + y0*hf.cs;
+	header.bmax[0] = hf.bmin[0] + (x0 + width)*hf.cs;
+	header.bmax[1] = hf.bmax[1];
+	header.bmax[2] = hf.bmin[2] + (y0 + height)*hf.cs;
+	header.cs = hf.cs;
+	header.ch = hf.ch;
+
+	rcExportView baseView;
+	if (base)
+	{
+		if (!readView(base, baseSize, baseView))
+			return false;
+		const rcExportHeader& bh = baseView.header;
+		if (bh.isDelta || bh.heightBits != header.heightBits || bh.width != width || bh.height != height ||
+			bh.tileSize != tileSize || bh.cs != header.cs || bh.ch != header.ch ||
+			bh.bmin[0] != header.bmin[0] || bh.bmin[1] != header.bmin[1] || bh.bmin[2] != header.bmin[2])
+			return false;
+		const unsigned long long hash = hashExport(base, baseSize);
+		header.isDelta = 1;
+		header.baseHash[0] = (unsigned int)hash;
+		header.baseHash[1] = (unsigned int)(hash >> 32);
+	}
+
+	const int ntiles = header.tilesX * header.tilesY;
+	rcExportTileData* tiles = (rcExportTileData*)rcAlloc(sizeof(rcExportTileData)*ntiles, RC_ALLOC_TEMP);
+	if (!tiles)
+		return false;
+	memset(tiles, 0, sizeof(rcExportTileData)*ntiles);
+
+	rcExportTask<Layout> task = { &hf, x0, y0, width, height, tileSize, header.tilesX, tiles };
+	rcParallelFor(ntiles, 1, encodeTiles<Layout>, &task);
+
+	bool ok = true;
+	size_t payloadSize = 0;
+	for (int i = 0; i < ntiles && ok; ++i)
+	{
+		rcExportTileData& tile = tiles[i];
+		ok = !tile.failed;
+		header.spanCount += tile.spanCount;
+		// Drop the tiles the base already has.
+		if (base)
+		{
+			const rcExportTile& bt = baseView.tiles[i];
+			if (bt.offset != RC_EXPORT_TILE_BASE && bt.size == (unsigned int)tile.size &&
+				(size_t)bt.offset + bt.size <= baseView.payloadSize &&
+				memcmp(baseView.payload + bt.offset, tile.data, tile.size) == 0)
+			{
+				rcFree(tile.data);
+				tile.data = 0;
+				tile.size = -1;
+				continue;
+			}
+		}
+		payloadSize += tile.size;
+	}
+
+	const size_t total = sizeof(rcExportHeader) + sizeof(rcExportTile)*(size_t)ntiles + payloadSize;
+	if (ok && total > 0x7fffffff)
+		ok = false;
+	if (ok)
+	{
+		out.data = (unsigned char*)rcAlloc((int)total, RC_ALLOC_PERM);
+		ok = out.data != 0;
+	}
+	if (ok)
+	{
+		out.size = (int)total;
+		memcpy(out.data, &header, sizeof(header));
+		rcExportTile* index = (rcExportTile*)(out.data + sizeof(rcExportHeader));
+		unsigned char* payload = (unsigned char*)(index + ntiles);
+		unsigned int offset = 0;
+		for (int i = 0; i < ntiles; ++i)
+		{
+			const rcExportTileData& tile = tiles[i];
+			if (tile.size < 0)
+			{
+				index[i].offset = RC_EXPORT_TILE_BASE;
+				index[i].size = 0;
+				continue;
+			}
+			index[i].offset = offset;
+			index[i].size = (unsigned int)tile.size;
+			if (tile.size)
+				memcpy(payload + offset, tile.data, tile.size);
+			offset += tile.size;
+		}
+	}
+
+	for (int i = 0; i < ntiles; ++i)
+		rcFree(tiles[i].data);
+	rcFree(tiles);
+	return ok;
+}
+
+void rcFreeExportBuffer(rcExportBuffer& buf)
+{
+	rcFree(buf.data);
+	buf.data = 0;
+	buf.size = 0;
+}
+
+bool rcReadExportHeader(const unsigned char* data, const int size, rcExportHeader& header)
+{
+	if (!data || size < (int)sizeof(rcExportHeader))
+		return false;
+	memcpy(&header, data, sizeof(header));
+	return header.magic == RC_EXPORT_MAGIC && header.version == RC_EXPORT_VERSION &&
+		header.width > 0 && header.height > 0 && header.tileSize > 0 &&
+		header.tilesX == ((long long)header.width + header.tileSize - 1) / header.tileSize &&
+		header.tilesY == ((long long)header.height + header.tileSize - 1) / header.tileSize;
+}
+
+/// Adds the decoded spans of a column from the top down, so that each one goes in at
+/// the head of the column. Spans come sorted and apart, so adding them never merges.
+template<class Layout>
+static bool addColumn(rcHeightfieldT<Layout>& hf, const int x, const int y, const rcIntArray& spans)
+{
+	for (int i = spans.size() - 3; i >= 0; i -= 3)
+	{
+		if (!rcAddSpan(hf, x, y, (unsigned short)spans[i], (unsigned short)spans[i + 1], (unsigned char)spans[i + 2], 0))
+			return false;
+	}
+	return true;
+}
+
+/// Reads the runs of one tile payload into the columns [cx0, cx1) x [cy0, cy1) of @p hf.
+template<class Layout>
+static bool decodeTile(const unsigned char* p, const unsigned char* end,
+					   const int cx0, const int cy0, const int cx1, const int cy1, rcHeightfieldT<Layout>& hf)
+{
+	// An empty tile has no payload.
+	if (p == end)
+		return true;
+
+	unsigned int countsSize, heightsSize;
+	p = readVarint(p, end, countsSize);
+	if (p)
+		p = readVarint(p, end, heightsSize);
+	if (!p || countsSize > (size_t)(end - p) || heightsSize > (size_t)(end - p) - countsSize)
+		return false;
+	const unsigned char* pc = p;
+	const unsigned char* countsEnd = pc + countsSize;
+	const unsigned char* ph = countsEnd;
+	const unsigned char* heightsEnd = ph + heightsSize;
+	const unsigned char* pa = heightsEnd;
+
+	unsigned int countRun = 0, token = 0;
+	unsigned int areaRun = 0, area = 0;
+	int prevFirst = 0;
+	// The spans of the last column that had its own heights, as (smin, smax, area).
+	rcIntArray column;
+	for (int y = cy0; y < cy1; ++y)
+	{
+		for (int x = cx0; x < cx1; ++x)
+		{
+			if (!countRun)
+			{
+				pc = readVarint(pc, countsEnd, countRun);
+				if (pc)
+					pc = readVarint(pc, countsEnd, token);
+				if (!pc || !countRun)
+					return false;
+			}
+			countRun--;
+
+			const unsigned int count = token >> 1;
+			if (token & 1)
+			{
+				if (!count || count*3 != (unsigned int)column.size() || !addColumn(hf, x, y, column))
+					return false;
+				continue;
+			}
+			if (!count)
+				continue;
+
+			column.resize(0);
+			int prevTop = -1;
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				unsigned int gap, size;
+				ph = readVarint(ph, heightsEnd, gap);
+				if (ph)
+					ph = readVarint(ph, heightsEnd, size);
+				if (!ph || gap > (unsigned int)Layout::MaxHeight*2 + 1 || size > (unsigned int)Layout::MaxHeight)
+					return false;
+				int smin;
+				if (prevTop < 0)
+				{
+					smin = prevFirst + unzigzag(gap);
+					prevFirst = smin;
+				}
+				else
+					smin = prevTop + 1 + (int)gap;
+				const int smax = smin + (int)size;
+				if (smin < 0 || smax > Layout::MaxHeight || smax < smin)
+					return false;
+				prevTop = smax;
+
+				if (!areaRun)
+				{
+					pa = readVarint(pa, end, areaRun);
+					if (!pa || pa >= end || !areaRun)
+						return false;
+					area = *pa++;
+				}
+				areaRun--;
+
+				column.push(smin);
+				column.push(smax);
+				column.push((int)area);
+			}
+			if (!addColumn(hf, x, y, column))
+				return false;
+		}
+	}
+	return true;
+}
+
+template<class Layout>
+bool rcDecodeExportTile(const unsigned char* data, const int size, const unsigned char* base, const int baseSize,
+						const int tx, const int ty, rcHeightfieldT<Layout>& hf)
+{
+	rcExportView view;
+	if (!readView(data, size, view) || view.header.heightBits > Layout::HeightBits ||
+		hf.width != view.header.width || hf.height != view.header.height ||
+		tx < 0 || ty < 0 || tx >= view.header.tilesX || ty >= view.header.tilesY)
+		return false;
+
+	const int i = tx + ty*view.header.tilesX;
+	const rcExportTile* tile = &view.tiles[i];
+	const unsigned char* payload = view.payload;
+	unsigned int payloadSize = view.payloadSize;
+	if (tile->offset == RC_EXPORT_TILE_BASE)
+	{
+		rcExportView baseView;
+		if (!view.header.isDelta || !readView(base, baseSize, baseView) || baseView.header.isDelta ||
+			baseView.header.tilesX != view.header.tilesX || baseView.header.tilesY != view.header.tilesY)
+			return false;
+		tile = &baseView.tiles[i];
+		payload = baseView.payload;
+		payloadSize = baseView.payloadSize;
+		if (tile->offset == RC_EXPORT_TILE_BASE)
+			return false;
+	}
+	if ((size_t)tile->offset + tile->size > payloadSize)
+		return false;
+
+	const int tileSize = view.header.tileSize;
+	const unsigned char* p = payload + tile->offset;
+	return decodeTile(p, p + tile->size, tx*tileSize, ty*tileSize,
+		rcMin((tx + 1)*tileSize, view.header.width), rcMin((ty + 1)*tileSize, view.header.height), hf);
+}
+
+/// @par
+///
+/// The base of a delta export is checked against the hash in the header once here,
+/// while #rcDecodeExportTile only checks that its grid matches.
+///
+/// @see rcEncodeHeightfield
+template<class Layout>
+bool rcDecodeHeightfield(const unsigned char* data, const int size, const unsigned char* base, const int baseSize,
+						 rcHeightfieldT<Layout>& hf, rcExportHeader& header)
+{
+	// Checks the index fits the buffer before the grid is allocated from the header.
+	rcExportView view;
+	if (!readView(data, size, view) || view.header.heightBits > Layout::HeightBits)
+		return false;
+	header = view.header;
+	if (header.isDelta)
+	{
+		if (!base)
+			return false;
+		const unsigned long long hash = hashExport(base, baseSize);
+		if (header.baseHash[0] != (unsigned int)hash || header.baseHash[1] != (unsigned int)(hash >> 32))
+			return false;
+	}
+	if (!rcCreateHeightfield(hf, header.width, header.height, header.bmin, header.bmax, header.cs, header.ch))
+		return false;
+
+	for (int ty = 0; ty < header.tilesY; ++ty)
+		for (int tx = 0; tx < header.tilesX; ++tx)
+			if (!rcDecodeExportTile(data, size, base, baseSize, tx, ty, hf))
+				return false;
+	return true;
+}
+
+#define RC_INSTANTIATE_EXPORT(Layout) \
+	template bool rcEncodeHeightfield<Layout>(const rcHeightfieldT<Layout>&, const int, const int, \
+		const int, const int, const int, const unsigned char*, const int, rcExportBuffer&); \
+	template bool rcDecodeExportTile<Layout>(const unsigned char*, const int, const unsigned char*, const int, \
+		const int, const int, rcHeightfieldT<Layout>&); \
+	template bool rcDecodeHeightfield<Layout>(const unsigned char*, const int, const unsigned char*, const int, \
+		rcHeightfieldT<Layout>&, rcExportHeader&);
+RC_FOR_EACH_SPAN_LAYOUT(RC_INSTANTIATE_EXPORT)
@@ -0,0 +1,138 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+
+#ifndef RECASTEXPORT_H
+#define RECASTEXPORT_H
+
+#include "Recast.h"
+
+static const int RC_EXPORT_MAGIC = 'R'<<24 | 'C'<<16 | 'H'<<8 | 'E';
+static const int RC_EXPORT_VERSION = 1;
+
+/// Index offset of a tile that is unchanged from the base of a delta export.
+static const unsigned int RC_EXPORT_TILE_BASE = 0xffffffff;
+
+/// Header of a compressed heightfield export.
+/// The header is followed by the tile index, one #rcExportTile per tile in row major
+/// order, and then the tile payloads.
+///
+/// A tile payload stores its columns in row major order as three sections: the column
+/// tokens as runs of (varint length, varint token), the span heights, and the area ids
+/// as runs of (varint length, byte area). Sections start with their varint byte size,
+/// except the last one. A token is the span count of the column shifted left by one,
+/// with the low bit set if the column repeats the previous column that has spans, in
+/// which case it has no heights or areas. The first span of a column stores its zigzag
+/// smin delta from the first span of the previous column, the following ones the gap
+/// above the span below, and every span its varint height.
+struct rcExportHeader
+{
+	int magic;			///< #RC_EXPORT_MAGIC
+	int version;		///< #RC_EXPORT_VERSION
+	int heightBits;		///< The span height bits of the layout the export was encoded from.
+	int width;			///< The width of the exported window. [Units: vx]
+	int height;			///< The height of the exported window. [Units: vx]
+	int tileSize;		///< The size of the tiles of the index. [Units: vx]
+	int tilesX;			///< The number of tiles along x.
+	int tilesY;			///< The number of tiles along y.
+	float bmin[3];		///< The minimum bounds of the exported window. [(x, y, z)]
+	float bmax[3];		///< The maximum bounds of the exported window. [(x, y, z)]
+	float cs;			///< The size of each cell. (On the xz-plane.)
+	float ch;			///< The height of each cell. (The minimum increment along the y-axis.)
+	int spanCount;		///< The number of spans in the export.
+	int isDelta;		///< Non-zero if unchanged tiles refer to a base export.
+	unsigned int baseHash[2];	///< The hash of the base export if #isDelta is set, as low and high words.
+};
+
+/// Entry of the tile index of an export.
+struct rcExportTile
+{
+	unsigned int offset;	///< The offset of the payload from the end of the index, or #RC_EXPORT_TILE_BASE.
+	unsigned int size;		///< The size of the payload. [Units: bytes]
+};
+
+/// A byte buffer holding an export.
+/// @see rcFreeExportBuffer
+struct rcExportBuffer
+{
+	unsigned char* data;	///< The bytes of the export, allocated with #rcAlloc.
+	int size;				///< The number of bytes of the export.
+};
+
+/// Encodes a window of the heightfield as a compressed export.
+/// Tiles are encoded in parallel with #rcParallelFor. With a base export, tiles whose
+/// payload is the same as in the base are only kept in the index.
+///  @param[in]		hf				The heightfield.
+///  @param[in]		x0, y0			The first cell of the window.
+///  @param[in]		width, height	The size of the window. [Units: vx]
+///  @param[in]		tileSize		The size of the tiles of the index. [Units: vx]
+///  @param[in]		base			A full export of the same window to encode against, or null.
+///  @param[in]		baseSize		The size of @p base. [Units: bytes]
+///  @param[out]	out				The export, release it with #rcFreeExportBuffer.
+///  @return False if the window is out of the heightfield, @p base is not a full export
+///  of the same window and tile size, or memory ran out.
+template<class Layout>
+bool rcEncodeHeightfield(const rcHeightfieldT<Layout>& hf, const int x0, const int y0,
+						 const int width, const int height, const int tileSize,
+						 const unsigned char* base, const int baseSize, rcExportBuffer& out);
+
+/// Releases the bytes of an export buffer.
+void rcFreeExportBuffer(rcExportBuffer& buf);
+
+/// Reads and checks the header of an export.
+///  @return False if @p data is not an export or is truncated.
+bool rcReadExportHeader(const unsigned char* data, const int size, rcExportHeader& header);
+
+/// Adds the spans of one tile of an export to the heightfield.
+///  @param[in]		data, size		The export.
+///  @param[in]		base, baseSize	The base of a delta export, or null for a full export.
+///  @param[in]		tx, ty			The tile coordinates.
+///  @param[in,out]	hf				A heightfield created with the window of the export as its grid.
+///  @return False if the export is corrupt, the base does not match, or the spans do not fit @p Layout.
+template<class Layout>
+bool rcDecodeExportTile(const unsigned char* data, const int size, const unsigned char* base, const int baseSize,
+						const int tx, const int ty, rcHeightfieldT<Layout>& hf);
+
+/// Decodes a whole export into an allocated, uninitialized heightfield.
+///  @param[in]		data, size		The export.
+///  @param[in]		base, baseSize	The base of a delta export, or null for a full export.
+///  @param[out]	hf				The heightfield, created with the window of the export as its grid.
+///  @param[out]	header			The export header.
+///  @return False if the export is corrupt, the base does not match, or the spans do not fit @p Layout.
+template<class Layout>
+bool rcDecodeHeightfield(const unsigned char* data, const int size, const unsigned char* base, const int baseSize,
+						 rcHeightfieldT<Layout>& hf, rcExportHeader& header);
+
+#endif
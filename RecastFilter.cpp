@@ -0,0 +1,299 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+#include "Recast.h"
+#include "RecastMath.h"
+#include "RecastParallel.h"
+
+/// Open height above the highest span of a column. Above the span heights of every layout.
+static const int MAX_HEIGHT = 0x1ffff;
+
+/// Filters run one task item per row of bricks.
+template<class Layout>
+struct rcFilterTask
+{
+	rcHeightfieldT<Layout>* solid;
+	int walkableHeight;
+	int walkableClimb;
+	int bandOffset;		///< Band index of the first task item. (Ledge filter only.)
+	int bandStride;		///< Band index step between task items. (Ledge filter only.)
+};
+
+template<class Layout>
+static void filterLowHangingWalkableObstaclesBands(void* userData, int begin, int end)
+{
+	const rcFilterTask<Layout>& task = *(const rcFilterTask<Layout>*)userData;
+	const rcHeightfieldT<Layout>& solid = *task.solid;
+
+	for (int by = begin; by < end; ++by)
+	{
+		for (int bx = 0; bx < solid.brickWidth; ++bx)
+		{
+			// Empty bricks were never allocated.
+			const rcSpanBrickT<Layout>* brick = solid.bricks[bx + by*solid.brickWidth];
+			if (!brick)
+				continue;
+
+			for (int ly = 0; ly < RC_BRICK_SIZE; ++ly)
+			{
+				// Only visit the occupied columns of the row.
+				for (unsigned int mask = brick->rowMask[ly]; mask; mask &= mask - 1)
+				{
+					const int lx = rcLowestBit(mask);
+					rcSpanT<Layout>* ps = 0;
+					bool previousWalkable = false;
+					unsigned char previousArea = RC_NULL_AREA;
+
+					for (rcSpanT<Layout>* s = brick->spans[rcBrickColumnIndex(lx, ly)]; s; ps = s, s = s->next)
+					{
+						const bool walkable = s->data.area != RC_NULL_AREA;
+						// If current span is not walkable, but there is walkable
+						// span just below it, mark the span above it walkable too.
+						if (!walkable && previousWalkable)
+						{
+							if (rcAbs((int)s->data.smax - (int)ps->data.smax) <= task.walkableClimb)
+								s->data.area = previousArea;
+						}
+						// Copy walkable flag so that it cannot propagate
+						// past multiple non-walkable objects.
+						previousWalkable = walkable;
+						previousArea = (unsigned char)s->data.area;
+					}
+				}
+			}
+		}
+	}
+}
+
+/// @par
+///
+/// Allows the formation of walkable regions that will flow over low lying 
+/// objects such as curbs, and up structures such as stairways. 
+/// 
+/// Two neighboring spans are walkable if: <tt>rcAbs(currentSpan.smax - neighborSpan.smax) < walkableClimb</tt>
+/// 
+/// @warning Will override the effect of #rcFilterLedgeSpans.  So if both filters are used, call
+/// #rcFilterLedgeSpans after calling this filter. 
+///
+/// @see rcHeightfield
+template<class Layout>
+void rcFilterLowHangingWalkableObstacles(const int walkableClimb, rcHeightfieldT<Layout>& solid)
+{
+	rcFilterTask<Layout> task = { &solid, 0, walkableClimb, 0, 1 };
+	rcParallelFor(solid.brickHeight, 1, filterLowHangingWalkableObstaclesBands<Layout>, &task);
+}
+
+template<class Layout>
+static void filterLedgeSpansBands(void* userData, int begin, int end)
+{
+	const rcFilterTask<Layout>& task = *(const rcFilterTask<Layout>*)userData;
+	const rcHeightfieldT<Layout>& solid = *task.solid;
+	const int w = solid.width;
+	const int h = solid.height;
+	const int walkableHeight = task.walkableHeight;
+	const int walkableClimb = task.walkableClimb;
+
+	for (int i = begin; i < end; ++i)
+	{
+		const int by = task.bandOffset + i * task.bandStride;
+
+		for (int bx = 0; bx < solid.brickWidth; ++bx)
+		{
+			// Empty bricks were never allocated.
+			const rcSpanBrickT<Layout>* brick = solid.bricks[bx + by*solid.brickWidth];
+			if (!brick)
+				continue;
+
+			for (int ly = 0; ly < RC_BRICK_SIZE; ++ly)
+			{
+				// Only visit the occupied columns of the row.
+				for (unsigned int mask = brick->rowMask[ly]; mask; mask &= mask - 1)
+				{
+					const int lx = rcLowestBit(mask);
+					const int x = (bx << RC_BRICK_SHIFT) + lx;
+					const int y = (by << RC_BRICK_SHIFT) + ly;
+
+					for (rcSpanT<Layout>* s = brick->spans[rcBrickColumnIndex(lx, ly)]; s; s = s->next)
+					{
+						// Skip non walkable spans.
+						if (s->data.area == RC_NULL_AREA)
+							continue;
+
+						const int bot = (int)(s->data.smax);
+						const int top = s->next ? (int)(s->next->data.smin) : MAX_HEIGHT;
+
+						// Find neighbours minimum height.
+						int minh = MAX_HEIGHT;
+
+						// Min and max height of accessible neighbours.
+						int asmin = s->data.smax;
+						int asmax = s->data.smax;
+
+						for (int dir = 0; dir < 4; ++dir)
+						{
+							int dx = x + rcGetDirOffsetX(dir);
+							int dy = y + rcGetDirOffsetY(dir);
+							// Skip neighbours which are out of bounds.
+							if (dx < 0 || dy < 0 || dx >= w || dy >= h)
+							{
+								minh = rcMin(minh, -walkableClimb - bot);
+								continue;
+							}
+
+							// From minus infinity to the first span.
+							const rcSpanT<Layout>* ns = rcGetColumn(solid, dx, dy);
+							int nbot = -walkableClimb;
+							int ntop = ns ? (int)ns->data.smin : MAX_HEIGHT;
+							// Skip neighbour if the gap between the spans is too small.
+							if (rcMin(top,ntop) - rcMax(bot,nbot) > walkableHeight)
+								minh = rcMin(minh, nbot - bot);
+
+							// Rest of the spans.
+							for (; ns; ns = ns->next)
+							{
+								nbot = (int)ns->data.smax;
+								ntop = ns->next ? (int)ns->next->data.smin : MAX_HEIGHT;
+								// Skip neighbour if the gap between the spans is too small.
+								if (rcMin(top,ntop) - rcMax(bot,nbot) > walkableHeight)
+								{
+									minh = rcMin(minh, nbot - bot);
+
+									// Find min/max accessible neighbour height. 
+									if (rcAbs(nbot - bot) <= walkableClimb)
+									{
+										if (nbot < asmin) asmin = nbot;
+										if (nbot > asmax) asmax = nbot;
+									}
+								}
+							}
+						}
+
+						// The current span is close to a ledge if the drop to any
+						// neighbour span is less than the walkableClimb.
+						if (minh < -walkableClimb)
+							s->data.area = RC_NULL_AREA;
+
+						// If the difference between all neighbours is too large,
+						// we are at steep slope, mark the span as ledge.
+						if ((asmax - asmin) > walkableClimb)
+						{
+							s->data.area = RC_NULL_AREA;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/// @par
+///
+/// A ledge is a span with one or more neighbors whose maximum is further away than @p walkableClimb
+/// from the current span's maximum.
+/// This method removes the impact of the overestimation of conservative voxelization 
+/// so the resulting mesh will not have regions hanging in the air over ledges.
+/// 
+/// A span is a ledge if: <tt>rcAbs(currentSpan.smax - neighborSpan.smax) > walkableClimb</tt>
+/// 
+/// The span bit fields share a word with the area id, so a band must not be
+/// written while its neighbour reads it as a halo. Even bands are filtered
+/// first, then odd bands.
+///
+/// @see rcHeightfield
+template<class Layout>
+void rcFilterLedgeSpans(const int walkableHeight, const int walkableClimb, rcHeightfieldT<Layout>& solid)
+{
+	const int nbands = solid.brickHeight;
+
+	for (int parity = 0; parity < 2; ++parity)
+	{
+		rcFilterTask<Layout> task = { &solid, walkableHeight, walkableClimb, parity, 2 };
+		rcParallelFor((nbands - parity + 1) / 2, 1, filterLedgeSpansBands<Layout>, &task);
+	}
+}
+
+template<class Layout>
+static void filterWalkableLowHeightSpansBands(void* userData, int begin, int end)
+{
+	const rcFilterTask<Layout>& task = *(const rcFilterTask<Layout>*)userData;
+	const rcHeightfieldT<Layout>& solid = *task.solid;
+
+	// Remove walkable flag from spans which do not have enough
+	// space above them for the agent to stand there.
+	for (int by = begin; by < end; ++by)
+	{
+		for (int bx = 0; bx < solid.brickWidth; ++bx)
+		{
+			// Empty bricks were never allocated.
+			const rcSpanBrickT<Layout>* brick = solid.bricks[bx + by*solid.brickWidth];
+			if (!brick)
+				continue;
+
+			for (int ly = 0; ly < RC_BRICK_SIZE; ++ly)
+			{
+				// Only visit the occupied columns of the row.
+				for (unsigned int mask = brick->rowMask[ly]; mask; mask &= mask - 1)
+				{
+					const int lx = rcLowestBit(mask);
+					for (rcSpanT<Layout>* s = brick->spans[rcBrickColumnIndex(lx, ly)]; s; s = s->next)
+					{
+						const int bot = (int)(s->data.smax);
+						const int top = s->next ? (int)(s->next->data.smin) : MAX_HEIGHT;
+						if ((top - bot) <= task.walkableHeight)
+							s->data.area = RC_NULL_AREA;
+					}
+				}
+			}
+		}
+	}
+}
+
+/// @par
+///
+/// For this filter, the clearance above the span is the distance from the span's 
+/// maximum to the next higher span's minimum. (Same grid column.)
+/// 
+/// @see rcHeightfield
+template<class Layout>
+void rcFilterWalkableLowHeightSpans(const int walkableHeight, rcHeightfieldT<Layout>& solid)
+{
+	rcFilterTask<Layout> task = { &solid, walkableHeight, 0, 0, 1 };
+	rcParallelFor(solid.brickHeight, 1, filterWalkableLowHeightSpansBands<Layout>, &task);
+}
+
+#define RC_INSTANTIATE_FILTERS(Layout) \
+	template void rcFilterLowHangingWalkableObstacles<Layout>(const int, rcHeightfieldT<Layout>&); \
+	template void rcFilterLedgeSpans<Layout>(const int, const int, rcHeightfieldT<Layout>&); \
+	template void rcFilterWalkableLowHeightSpans<Layout>(const int, rcHeightfieldT<Layout>&);
+RC_FOR_EACH_SPAN_LAYOUT(RC_INSTANTIATE_FILTERS)
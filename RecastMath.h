@@ -34,9 +34,14 @@
 #ifndef RECASTMATH_H
 #define RECASTMATH_H
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 template<class T> inline T rcMin(T a, T b) { return a < b ? a : b; }
 template<class T> inline T rcMax(T a, T b) { return a > b ? a : b; }
 template<class T> inline T rcAbs(T a) { return a < 0 ? -a : a; }
+template<class T> inline void rcSwap(T& a, T& b) { T t = a; a = b; b = t; }
 
 static inline int intMax(int a, int b)
 {
@@ -50,6 +55,30 @@ static inline int intMin(int a, int b)
 
 template<class T> inline T rcClamp(T v, T mn, T mx) { return v < mn ? mn : (v > mx ? mx : v); }
 
+/// Returns the index of the lowest set bit. @p v must not be zero.
+inline int rcLowestBit(unsigned int v)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, v);
+    return (int)index;
+#else
+    return __builtin_ctz(v);
+#endif
+}
+
+/// Returns the index of the lowest set bit. @p v must not be zero.
+inline int rcLowestBit64(unsigned long long v)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return (int)index;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
 /// Performs a vector copy.
 ///  @param[out]	dest	The result. [(x, y, z)]
 ///  @param[in]		v		The vector to copy. [(x, y, z)]
@@ -71,4 +100,16 @@ inline void rcVsub(float* dest, const float* v1, const float* v2)
     dest[2] = v1[2]-v2[2];
 }
 
+/// Performs a linear interpolation between two vectors. (@p v1 toward @p v2)
+///  @param[out]	dest	The result vector. [(x, y, x)]
+///  @param[in]		v1		The starting vector.
+///  @param[in]		v2		The destination vector.
+///  @param[in]		t		The interpolation factor. [Limits: 0 <= value <= 1.0]
+inline void rcVlerp(float* dest, const float* v1, const float* v2, const float t)
+{
+    dest[0] = v1[0]+(v2[0]-v1[0])*t;
+    dest[1] = v1[1]+(v2[1]-v1[1])*t;
+    dest[2] = v1[2]+(v2[2]-v1[2])*t;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,317 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+#include <string.h>
+
+#include "Recast.h"
+#include "RecastMath.h"
+#include "RecastAlloc.h"
+#include "RecastParallel.h"
+
+/// Span memory owned by one row of bricks while merging, spliced into the
+/// destination heightfield once all rows are done.
+template<class Layout>
+struct rcMergeRow
+{
+	rcSpanPoolT<Layout>* pools;
+	rcSpanT<Layout>* freelist;
+	int brickCount;		///< The number of bricks allocated in the row.
+	bool failed;
+};
+
+/// Merges run one task item per row of bricks.
+template<class Layout>
+struct rcMergeTask
+{
+	rcHeightfieldT<Layout>* dest;
+	const rcHeightfieldT<Layout>* const* sources;
+	int nsources;
+	int flagMergeThr;
+	rcMergeRow<Layout>* rows;
+};
+
+template<class Layout>
+static rcSpanT<Layout>* allocMergeSpan(rcMergeRow<Layout>& row)
+{
+	if (!row.freelist)
+	{
+		rcSpanPoolT<Layout>* pool = (rcSpanPoolT<Layout>*)rcAlloc(sizeof(rcSpanPoolT<Layout>), RC_ALLOC_PERM);
+		if (!pool)
+			return 0;
+		pool->next = row.pools;
+		row.pools = pool;
+		// Add new items to the free list.
+		rcSpanT<Layout>* head = &pool->items[0];
+		rcSpanT<Layout>* it = &pool->items[RC_SPANS_PER_POOL];
+		do
+		{
+			--it;
+			it->next = row.freelist;
+			row.freelist = it;
+		}
+		while (it != head);
+	}
+	rcSpanT<Layout>* s = row.freelist;
+	row.freelist = s->next;
+	return s;
+}
+
+template<class Layout>
+static void freeMergeSpans(rcMergeRow<Layout>& row, rcSpanT<Layout>* s)
+{
+	while (s)
+	{
+		rcSpanT<Layout>* next = s->next;
+		s->next = row.freelist;
+		row.freelist = s;
+		s = next;
+	}
+}
+
+/// Merges the sorted span lists in @p cursors into a new column.
+/// Overlapping spans are joined with the rules of addSpan: the area of the higher
+/// top wins, unless the tops are within @p flagMergeThr and the larger area wins.
+///  @return The new column, or null if out of memory.
+template<class Layout>
+static rcSpanT<Layout>* mergeColumn(rcMergeRow<Layout>& row, const rcSpanT<Layout>** cursors, const int ncursors,
+									const int flagMergeThr)
+{
+	rcSpanT<Layout>* head = 0;
+	rcSpanT<Layout>** tail = &head;
+	rcSpanT<Layout>* cur = 0;
+
+	for (;;)
+	{
+		// Take the lowest span left in any input.
+		int best = -1;
+		for (int i = 0; i < ncursors; ++i)
+		{
+			if (cursors[i] && (best < 0 || cursors[i]->data.smin < cursors[best]->data.smin))
+				best = i;
+		}
+		if (best < 0)
+			break;
+		const rcSpanT<Layout>* s = cursors[best];
+		cursors[best] = s->next;
+
+		if (cur && s->data.smin <= cur->data.smax)
+		{
+			if (rcAbs((int)s->data.smax - (int)cur->data.smax) <= flagMergeThr)
+				cur->data.area = rcMax(cur->data.area, s->data.area);
+			else if (s->data.smax > cur->data.smax)
+				cur->data.area = s->data.area;
+
+			if (s->data.smax > cur->data.smax)
+				cur->data.smax = s->data.smax;
+			continue;
+		}
+
+		cur = allocMergeSpan(row);
+		if (!cur)
+		{
+			freeMergeSpans(row, head);
+			return 0;
+		}
+		cur->data = s->data;
+		cur->next = 0;
+		*tail = cur;
+		tail = &cur->next;
+	}
+
+	return head;
+}
+
+template<class Layout>
+static void mergeHeightfieldsBands(void* userData, int begin, int end)
+{
+	const rcMergeTask<Layout>& task = *(const rcMergeTask<Layout>*)userData;
+	rcHeightfieldT<Layout>& dest = *task.dest;
+
+	const rcSpanT<Layout>** cursors = (const rcSpanT<Layout>**)rcAlloc(sizeof(rcSpanT<Layout>*)*(task.nsources + 1), RC_ALLOC_TEMP);
+
+	for (int by = begin; by < end; ++by)
+	{
+		rcMergeRow<Layout>& row = task.rows[by];
+		if (!cursors)
+		{
+			row.failed = true;
+			continue;
+		}
+
+		for (int bx = 0; bx < dest.brickWidth && !row.failed; ++bx)
+		{
+			const int bi = bx + by*dest.brickWidth;
+
+			// Columns holding spans in any source.
+			unsigned int rowMask[RC_BRICK_SIZE];
+			memset(rowMask, 0, sizeof(rowMask));
+			bool empty = true;
+			for (int i = 0; i < task.nsources; ++i)
+			{
+				const rcSpanBrickT<Layout>* brick = task.sources[i]->bricks[bi];
+				if (!brick)
+					continue;
+				for (int ly = 0; ly < RC_BRICK_SIZE; ++ly)
+					rowMask[ly] |= brick->rowMask[ly];
+				empty = false;
+			}
+			if (empty)
+				continue;
+
+			// Each brick belongs to one row, so rows never touch the same brick.
+			rcSpanBrickT<Layout>*& brick = dest.bricks[bi];
+			if (!brick)
+			{
+				brick = rcAllocBrick<Layout>();
+				if (!brick)
+				{
+					row.failed = true;
+					break;
+				}
+				row.brickCount++;
+			}
+
+			for (int ly = 0; ly < RC_BRICK_SIZE && !row.failed; ++ly)
+			{
+				for (unsigned int columns = rowMask[ly]; columns; columns &= columns - 1)
+				{
+					const int ci = rcBrickColumnIndex(rcLowestBit(columns), ly);
+					rcSpanT<Layout>* old = brick->spans[ci];
+					cursors[0] = old;
+					for (int i = 0; i < task.nsources; ++i)
+					{
+						const rcSpanBrickT<Layout>* src = task.sources[i]->bricks[bi];
+						cursors[i + 1] = src ? src->spans[ci] : 0;
+					}
+
+					rcSpanT<Layout>* merged = mergeColumn(row, cursors, task.nsources + 1, task.flagMergeThr);
+					if (!merged)
+					{
+						row.failed = true;
+						break;
+					}
+					freeMergeSpans(row, old);
+					brick->spans[ci] = merged;
+
+					// Spans are sorted, so the column range is the first minimum and the last maximum.
+					const rcSpanT<Layout>* top = merged;
+					while (top->next)
+						top = top->next;
+					brick->rowMask[ly] |= columns & (0u - columns);
+					if (merged->data.smin < brick->smin) brick->smin = (unsigned short)merged->data.smin;
+					if (top->data.smax > brick->smax) brick->smax = (unsigned short)top->data.smax;
+				}
+			}
+		}
+	}
+
+	rcFree(cursors);
+}
+
+/// @par
+///
+/// The destination keeps its own spans, which allows merging in several steps.
+/// Every row of bricks allocates spans from its own pools, which are handed to
+/// @p dest afterwards, and the groups of the occupancy pyramid are updated once
+/// all rows are done since they span several rows.
+///
+/// @see rcAllocHeightfield, rcHeightfieldT
+template<class Layout>
+bool rcMergeHeightfields(const rcHeightfieldT<Layout>* const* sources, const int nsources,
+						 rcHeightfieldT<Layout>& dest, const int flagMergeThr)
+{
+	for (int i = 0; i < nsources; ++i)
+	{
+		const rcHeightfieldT<Layout>& src = *sources[i];
+		if (&src == &dest || src.width != dest.width || src.height != dest.height ||
+			src.cs != dest.cs || src.ch != dest.ch ||
+			src.bmin[0] != dest.bmin[0] || src.bmin[1] != dest.bmin[1] || src.bmin[2] != dest.bmin[2])
+			return false;
+	}
+	if (nsources <= 0)
+		return true;
+
+	rcMergeRow<Layout>* rows = (rcMergeRow<Layout>*)rcAlloc(sizeof(rcMergeRow<Layout>)*dest.brickHeight, RC_ALLOC_TEMP);
+	if (!rows)
+		return false;
+	memset(rows, 0, sizeof(rcMergeRow<Layout>)*dest.brickHeight);
+
+	rcMergeTask<Layout> task = { &dest, sources, nsources, flagMergeThr, rows };
+	rcParallelFor(dest.brickHeight, 1, mergeHeightfieldsBands<Layout>, &task);
+
+	// Hand the span pools of every row to the heightfield.
+	bool ok = true;
+	for (int by = 0; by < dest.brickHeight; ++by)
+	{
+		rcMergeRow<Layout>& row = rows[by];
+		ok &= !row.failed;
+		dest.brickCount += row.brickCount;
+		while (row.pools)
+		{
+			rcSpanPoolT<Layout>* next = row.pools->next;
+			row.pools->next = dest.pools;
+			dest.pools = row.pools;
+			row.pools = next;
+		}
+		while (row.freelist)
+		{
+			rcSpanT<Layout>* next = row.freelist->next;
+			row.freelist->next = dest.freelist;
+			dest.freelist = row.freelist;
+			row.freelist = next;
+		}
+	}
+	rcFree(rows);
+
+	for (int by = 0; by < dest.brickHeight; ++by)
+	{
+		for (int bx = 0; bx < dest.brickWidth; ++bx)
+		{
+			const rcSpanBrickT<Layout>* brick = dest.bricks[bx + by*dest.brickWidth];
+			if (!brick || brick->smin > brick->smax)
+				continue;
+			rcBrickGroup& group = dest.groups[rcGroupIndex(dest, bx, by)];
+			group.brickMask |= rcGroupBrickBit(bx, by);
+			if (brick->smin < group.smin) group.smin = brick->smin;
+			if (brick->smax > group.smax) group.smax = brick->smax;
+		}
+	}
+
+	return ok;
+}
+
+#define RC_INSTANTIATE_MERGE(Layout) \
+	template bool rcMergeHeightfields<Layout>(const rcHeightfieldT<Layout>* const*, const int, rcHeightfieldT<Layout>&, const int);
+RC_FOR_EACH_SPAN_LAYOUT(RC_INSTANTIATE_MERGE)
@@ -0,0 +1,430 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <filesystem>
+
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+#include "RecastMeshLoaderObj.h"
+#include "RecastParallel.h"
+
+/// Read-only memory mapping of a whole file.
+class rcMappedFile
+{
+public:
+	rcMappedFile() : m_data(0), m_size(0)
+#ifdef _WIN32
+		, m_file(INVALID_HANDLE_VALUE), m_mapping(0)
+#endif
+	{
+	}
+
+	~rcMappedFile()
+	{
+#ifdef _WIN32
+		if (m_data) UnmapViewOfFile(m_data);
+		if (m_mapping) CloseHandle(m_mapping);
+		if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+#else
+		if (m_data) munmap((void*)m_data, m_size);
+#endif
+	}
+
+	bool open(const char* path)
+	{
+#ifdef _WIN32
+		m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+		if (m_file == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(m_file, &size))
+			return false;
+		m_size = (size_t)size.QuadPart;
+		if (m_size == 0)
+			return true;
+		m_mapping = CreateFileMappingA(m_file, 0, PAGE_READONLY, 0, 0, 0);
+		if (!m_mapping)
+			return false;
+		m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+		return m_data != 0;
+#else
+		const int fd = ::open(path, O_RDONLY);
+		if (fd < 0)
+			return false;
+		struct stat st;
+		if (fstat(fd, &st) != 0)
+		{
+			close(fd);
+			return false;
+		}
+		m_size = (size_t)st.st_size;
+		if (m_size == 0)
+		{
+			close(fd);
+			return true;
+		}
+		void* data = mmap(0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED)
+			return false;
+		m_data = (const char*)data;
+		return true;
+#endif
+	}
+
+	const char* data() const { return m_data; }
+	size_t size() const { return m_size; }
+
+private:
+	// Explicitly disabled copy constructor and copy assignment operator.
+	rcMappedFile(const rcMappedFile&);
+	rcMappedFile& operator=(const rcMappedFile&);
+
+	const char* m_data;
+	size_t m_size;
+#ifdef _WIN32
+	HANDLE m_file;
+	HANDLE m_mapping;
+#endif
+};
+
+static inline bool isBlank(const char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline const char* skipBlanks(const char* p, const char* end)
+{
+	while (p < end && isBlank(*p))
+		p++;
+	return p;
+}
+
+/// Parses a decimal float such as "-1.25e-3". Numbers with up to 19 significant
+/// digits and small exponents are exact; anything else falls back to strtod.
+static const char* parseFloat(const char* p, const char* end, float& value)
+{
+	static const double powers[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	const char* start = p;
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+		negative = *p++ == '-';
+
+	unsigned long long mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool any = false;
+	for (; p < end && *p >= '0' && *p <= '9'; ++p, any = true)
+	{
+		if (digits < 19) { mantissa = mantissa * 10 + (*p - '0'); if (mantissa) digits++; }
+		else exponent++;
+	}
+	if (p < end && *p == '.')
+	{
+		for (++p; p < end && *p >= '0' && *p <= '9'; ++p, any = true)
+		{
+			if (digits < 19) { mantissa = mantissa * 10 + (*p - '0'); if (mantissa) digits++; exponent--; }
+		}
+	}
+	if (!any)
+	{
+		value = 0.0f;
+		return start;
+	}
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		const char* e = p + 1;
+		bool negativeExp = false;
+		if (e < end && (*e == '-' || *e == '+'))
+			negativeExp = *e++ == '-';
+		if (e < end && *e >= '0' && *e <= '9')
+		{
+			int exp = 0;
+			for (; e < end && *e >= '0' && *e <= '9'; ++e)
+				exp = exp < 10000 ? exp * 10 + (*e - '0') : exp;
+			exponent += negativeExp ? -exp : exp;
+			p = e;
+		}
+	}
+
+	if (mantissa < (1ull << 53) && exponent >= -22 && exponent <= 22)
+	{
+		double d = (double)mantissa;
+		d = exponent < 0 ? d / powers[-exponent] : d * powers[exponent];
+		value = (float)(negative ? -d : d);
+	}
+	else
+	{
+		// Rare in mesh exports, let the C library round it.
+		char buf[64];
+		const size_t len = (size_t)(p - start) < sizeof(buf) - 1 ? (size_t)(p - start) : sizeof(buf) - 1;
+		memcpy(buf, start, len);
+		buf[len] = '\0';
+		value = (float)strtod(buf, 0);
+	}
+	return p;
+}
+
+static const char* parseInt(const char* p, const char* end, int& value, bool& ok)
+{
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+		negative = *p++ == '-';
+	int v = 0;
+	ok = false;
+	for (; p < end && *p >= '0' && *p <= '9'; ++p, ok = true)
+		v = v * 10 + (*p - '0');
+	value = negative ? -v : v;
+	return p;
+}
+
+/// What one chunk of lines holds, before indices are resolved against the other chunks.
+struct rcObjChunk
+{
+	const char* begin;
+	const char* end;
+	std::vector<float> verts;
+	std::vector<int> faceSizes;		///< The number of indices of every face.
+	std::vector<int> faceVertCounts;	///< The number of vertices of the chunk read before every face.
+	std::vector<int> indices;		///< The raw OBJ indices, 1-based or negative relative ones.
+	std::vector<int> tris;
+	int vertBase;					///< The number of vertices in all the chunks before.
+};
+
+static void parseChunks(void* userData, int begin, int end)
+{
+	std::vector<rcObjChunk>& chunks = *(std::vector<rcObjChunk>*)userData;
+	for (int i = begin; i < end; ++i)
+	{
+		rcObjChunk& chunk = chunks[i];
+		const char* p = chunk.begin;
+		const char* const e = chunk.end;
+		while (p < e)
+		{
+			p = skipBlanks(p, e);
+			const char* lineEnd = (const char*)memchr(p, '\n', e - p);
+			if (!lineEnd)
+				lineEnd = e;
+
+			if (lineEnd - p > 2 && p[0] == 'v' && isBlank(p[1]))
+			{
+				// Vertex position, extra components such as w or colors are ignored.
+				float v[3];
+				const char* q = p + 1;
+				int n = 0;
+				for (; n < 3; ++n)
+				{
+					q = skipBlanks(q, lineEnd);
+					const char* next = parseFloat(q, lineEnd, v[n]);
+					if (next == q)
+						break;
+					q = next;
+				}
+				if (n == 3)
+					chunk.verts.insert(chunk.verts.end(), v, v + 3);
+			}
+			else if (lineEnd - p > 2 && p[0] == 'f' && isBlank(p[1]))
+			{
+				// Face, only the position index of "v/vt/vn" is used.
+				const char* q = p + 1;
+				int n = 0;
+				for (;;)
+				{
+					q = skipBlanks(q, lineEnd);
+					if (q >= lineEnd)
+						break;
+					int vi;
+					bool ok;
+					q = parseInt(q, lineEnd, vi, ok);
+					if (ok && vi != 0)
+					{
+						chunk.indices.push_back(vi);
+						n++;
+					}
+					while (q < lineEnd && !isBlank(*q))
+						q++;
+				}
+				chunk.faceSizes.push_back(n);
+				chunk.faceVertCounts.push_back((int)chunk.verts.size() / 3);
+			}
+
+			p = lineEnd + 1;
+		}
+	}
+}
+
+struct rcObjResolveTask
+{
+	std::vector<rcObjChunk>* chunks;
+	int vertCount;
+};
+
+static void resolveChunks(void* userData, int begin, int end)
+{
+	const rcObjResolveTask& task = *(const rcObjResolveTask*)userData;
+	for (int i = begin; i < end; ++i)
+	{
+		rcObjChunk& chunk = (*task.chunks)[i];
+		const int* idx = chunk.indices.empty() ? 0 : &chunk.indices[0];
+		for (size_t f = 0; f < chunk.faceSizes.size(); ++f)
+		{
+			const int n = chunk.faceSizes[f];
+			// Relative indices count back from the last vertex read before the face.
+			const int current = chunk.vertBase + chunk.faceVertCounts[f];
+			int face[3];
+			for (int k = 0; k < n; ++k)
+			{
+				const int vi = idx[k] < 0 ? current + idx[k] : idx[k] - 1;
+				if (k < 2)
+				{
+					face[k] = vi;
+					continue;
+				}
+				// Triangulate as a fan.
+				face[2] = vi;
+				if (face[0] >= 0 && face[0] < task.vertCount && face[1] >= 0 && face[1] < task.vertCount &&
+					face[2] >= 0 && face[2] < task.vertCount)
+					chunk.tris.insert(chunk.tris.end(), face, face + 3);
+				face[1] = vi;
+			}
+			idx += n;
+		}
+	}
+}
+
+rcMeshLoaderObj::rcMeshLoaderObj()
+{
+}
+
+/// @par
+///
+/// The file is memory mapped and split into chunks of whole lines, which are
+/// parsed in parallel through #rcParallelFor. Face indices are resolved in a
+/// second parallel pass, once the vertex count before every chunk is known.
+bool rcMeshLoaderObj::load(const std::string& filename)
+{
+	rcMappedFile file;
+	if (!file.open(filename.c_str()))
+		return false;
+
+	m_filename = filename;
+	m_verts.clear();
+	m_tris.clear();
+
+	const char* data = file.data();
+	const size_t size = file.size();
+	if (!data)
+		return true;
+
+	// Chunks of about 4MB, cut after a line break.
+	const size_t chunkSize = 4 << 20;
+	std::vector<rcObjChunk> chunks((size + chunkSize - 1) / chunkSize);
+	const char* p = data;
+	const char* const end = data + size;
+	size_t count = 0;
+	for (; p < end && count < chunks.size(); ++count)
+	{
+		const char* cut = p + chunkSize < end ? p + chunkSize : end;
+		if (cut < end)
+		{
+			const char* nl = (const char*)memchr(cut, '\n', end - cut);
+			cut = nl ? nl + 1 : end;
+		}
+		chunks[count].begin = p;
+		chunks[count].end = cut;
+		p = cut;
+	}
+	chunks.resize(count);
+
+	rcParallelFor((int)chunks.size(), 1, parseChunks, &chunks);
+
+	int vertCount = 0;
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		chunks[i].vertBase = vertCount;
+		vertCount += (int)chunks[i].verts.size() / 3;
+	}
+
+	rcObjResolveTask task = { &chunks, vertCount };
+	rcParallelFor((int)chunks.size(), 1, resolveChunks, &task);
+
+	size_t triCount = 0;
+	for (size_t i = 0; i < chunks.size(); ++i)
+		triCount += chunks[i].tris.size();
+	m_verts.reserve((size_t)vertCount * 3);
+	m_tris.reserve(triCount);
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		m_verts.insert(m_verts.end(), chunks[i].verts.begin(), chunks[i].verts.end());
+		m_tris.insert(m_tris.end(), chunks[i].tris.begin(), chunks[i].tris.end());
+	}
+
+	return true;
+}
+
+bool rcFindObjFiles(const std::string& dir, std::vector<std::string>& paths)
+{
+	std::error_code ec;
+	std::filesystem::directory_iterator it(dir, ec);
+	if (ec)
+		return false;
+
+	std::vector<std::string> found;
+	for (; it != std::filesystem::directory_iterator(); it.increment(ec))
+	{
+		if (ec)
+			return false;
+		if (it->path().extension() == ".obj")
+			found.push_back(it->path().string());
+	}
+	std::sort(found.begin(), found.end());
+	paths.insert(paths.end(), found.begin(), found.end());
+	return true;
+}
@@ -0,0 +1,74 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+#ifndef RECASTMESHLOADEROBJ_H
+#define RECASTMESHLOADEROBJ_H
+
+#include <string>
+#include <vector>
+
+/// Loads the vertices and faces of a Wavefront OBJ file as a triangle mesh.
+/// The file is memory mapped and parsed in parallel chunks through #rcParallelFor.
+/// Polygons are triangulated as fans; normals, texture coordinates and groups are ignored.
+class rcMeshLoaderObj
+{
+public:
+	rcMeshLoaderObj();
+
+	/// Loads the mesh, replacing any previously loaded one.
+	///  @return False if the file could not be read.
+	bool load(const std::string& fileName);
+
+	const float* getVerts() const { return m_verts.empty() ? 0 : &m_verts[0]; }
+	const int* getTris() const { return m_tris.empty() ? 0 : &m_tris[0]; }
+	int getVertCount() const { return (int)m_verts.size() / 3; }
+	int getTriCount() const { return (int)m_tris.size() / 3; }
+	const std::string& getFileName() const { return m_filename; }
+
+private:
+	// Explicitly disabled copy constructor and copy assignment operator.
+	rcMeshLoaderObj(const rcMeshLoaderObj&);
+	rcMeshLoaderObj& operator=(const rcMeshLoaderObj&);
+
+	std::string m_filename;
+	std::vector<float> m_verts;
+	std::vector<int> m_tris;
+};
+
+/// Lists the OBJ files of a directory, sorted by name.
+///  @return False if the directory could not be read.
+bool rcFindObjFiles(const std::string& dir, std::vector<std::string>& paths);
+
+#endif
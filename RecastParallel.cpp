@@ -0,0 +1,98 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+#include "RecastParallel.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static void rcParallelForDefault(int count, int, rcParallelTaskFunc* task, void* userData)
+{
+	if (count > 0)
+		task(userData, 0, count);
+}
+
+static rcParallelForFunc* sRecastParallelForFunc = rcParallelForDefault;
+
+/// @see rcParallelFor
+void rcParallelSetCustom(rcParallelForFunc* parallelForFunc)
+{
+	sRecastParallelForFunc = parallelForFunc ? parallelForFunc : rcParallelForDefault;
+}
+
+/// @see rcParallelSetCustom
+void rcParallelFor(int count, int grain, rcParallelTaskFunc* task, void* userData)
+{
+	if (count <= 0)
+		return;
+	sRecastParallelForFunc(count, grain > 0 ? grain : 1, task, userData);
+}
+
+static int sRecastThreadCount = 0;
+
+/// @see rcParallelForThreads
+void rcParallelSetThreadCount(int count)
+{
+	sRecastThreadCount = count > 0 ? count : 0;
+}
+
+/// @see rcParallelSetCustom
+void rcParallelForThreads(int count, int grain, rcParallelTaskFunc* task, void* userData)
+{
+	const int chunks = (count + grain - 1) / grain;
+	int nthreads = sRecastThreadCount > 0 ? sRecastThreadCount : (int)std::thread::hardware_concurrency();
+	nthreads = nthreads < chunks ? nthreads : chunks;
+	if (nthreads <= 1)
+	{
+		task(userData, 0, count);
+		return;
+	}
+
+	std::atomic<int> next(0);
+	auto run = [&]()
+	{
+		for (int i = next++; i < chunks; i = next++)
+		{
+			const int end = (i + 1) * grain;
+			task(userData, i * grain, end < count ? end : count);
+		}
+	};
+	std::vector<std::thread> threads;
+	for (int i = 1; i < nthreads; ++i)
+		threads.push_back(std::thread(run));
+	run();
+	for (size_t i = 0; i < threads.size(); ++i)
+		threads[i].join();
+}
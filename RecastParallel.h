@@ -0,0 +1,73 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+#ifndef RECASTPARALLEL_H
+#define RECASTPARALLEL_H
+
+/// A parallel task function.
+///  @param[in]		userData	The user data passed to #rcParallelFor.
+///  @param[in]		begin		The first item of the range to process.
+///  @param[in]		end			One past the last item of the range to process.
+typedef void (rcParallelTaskFunc)(void* userData, int begin, int end);
+
+/// A parallel loop function.
+/// Must call @p task on disjoint sub-ranges covering [0, @p count) and return
+/// only once all of them have completed.
+///  @param[in]		count		The number of items to process.
+///  @param[in]		grain		The minimum number of items handed to a single task call.
+///  @param[in]		task		The task to run over each sub-range.
+///  @param[in]		userData	The user data forwarded to @p task.
+/// @see rcParallelSetCustom
+typedef void (rcParallelForFunc)(int count, int grain, rcParallelTaskFunc* task, void* userData);
+
+/// Sets the parallel loop function to be used by Recast.
+/// The default implementation runs the whole range on the calling thread.
+///  @param[in]		parallelForFunc	The parallel loop function to be used by #rcParallelFor
+void rcParallelSetCustom(rcParallelForFunc* parallelForFunc);
+
+/// Runs @p task over [0, @p count) using the current parallel loop function.
+/// @see rcParallelSetCustom
+void rcParallelFor(int count, int grain, rcParallelTaskFunc* task, void* userData);
+
+/// A parallel loop function on plain threads, for tools without a task scheduler.
+/// It starts the threads on every call and hands out grain sized chunks of the range.
+/// Install it with #rcParallelSetCustom.
+/// @see rcParallelForFunc, rcParallelSetThreadCount
+void rcParallelForThreads(int count, int grain, rcParallelTaskFunc* task, void* userData);
+
+/// Sets the number of threads used by #rcParallelForThreads.
+///  @param[in]		count		The number of threads, 0 for one per hardware thread.
+void rcParallelSetThreadCount(int count);
+
+#endif
@@ -0,0 +1,247 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+#include "Recast.h"
+#include "RecastMath.h"
+#include <cfloat>
+#include <cmath>
+
+template<class Layout>
+bool rcQueryWalkableHeight(const rcHeightfieldT<Layout>& hf, const float* pos, float& top, float& clearance)
+{
+	const int x = (int)floorf((pos[0] - hf.bmin[0]) / hf.cs);
+	const int y = (int)floorf((pos[2] - hf.bmin[2]) / hf.cs);
+	if (x < 0 || y < 0 || x >= hf.width || y >= hf.height)
+		return false;
+
+	const float sy = (pos[1] - hf.bmin[1]) / hf.ch;
+	float bestDist = FLT_MAX;
+	const rcSpanT<Layout>* best = 0;
+
+	for (const rcSpanT<Layout>* s = rcGetColumn(hf, x, y); s; s = s->next)
+	{
+		if (s->data.area == RC_NULL_AREA)
+			continue;
+		const float dist = rcAbs((float)s->data.smax - sy);
+		if (dist < bestDist)
+		{
+			bestDist = dist;
+			best = s;
+		}
+		else
+		{
+			// Spans are sorted upwards, the distance only grows from here.
+			break;
+		}
+	}
+
+	if (!best)
+		return false;
+
+	top = hf.bmin[1] + best->data.smax * hf.ch;
+	clearance = best->next ? (best->next->data.smin - best->data.smax) * hf.ch : FLT_MAX;
+	return true;
+}
+
+/// Steps through the square cells of size @p cellSize crossed by the ray between
+/// @p tmin and @p tmax, in grid units, calling @p visit(cx, cy, ta, tb) for each
+/// cell until it returns true.
+template<class Visitor>
+static bool traverseCells(const float* o, const float* d, float tmin, float tmax, const int cellSize,
+						  const int cx0, const int cy0, const int cx1, const int cy1, Visitor& visit)
+{
+	const float px = o[0] + d[0]*tmin;
+	const float py = o[2] + d[2]*tmin;
+	int cx = rcClamp((int)floorf(px / cellSize), cx0, cx1);
+	int cy = rcClamp((int)floorf(py / cellSize), cy0, cy1);
+
+	const int stepx = d[0] > 0.0f ? 1 : -1;
+	const int stepy = d[2] > 0.0f ? 1 : -1;
+	const float tdeltax = d[0] != 0.0f ? cellSize / rcAbs(d[0]) : FLT_MAX;
+	const float tdeltay = d[2] != 0.0f ? cellSize / rcAbs(d[2]) : FLT_MAX;
+	float tnextx = d[0] != 0.0f ? ((cx + (stepx > 0 ? 1 : 0)) * cellSize - o[0]) / d[0] : FLT_MAX;
+	float tnexty = d[2] != 0.0f ? ((cy + (stepy > 0 ? 1 : 0)) * cellSize - o[2]) / d[2] : FLT_MAX;
+
+	float ta = tmin;
+	while (ta <= tmax)
+	{
+		const float tb = rcMin(rcMin(tnextx, tnexty), tmax);
+		if (visit(cx, cy, ta, tb))
+			return true;
+		if (tb >= tmax)
+			break;
+
+		if (tnextx < tnexty)
+		{
+			cx += stepx;
+			tnextx += tdeltax;
+		}
+		else
+		{
+			cy += stepy;
+			tnexty += tdeltay;
+		}
+		if (cx < cx0 || cy < cy0 || cx > cx1 || cy > cy1)
+			break;
+		ta = tb;
+	}
+	return false;
+}
+
+template<class Layout>
+struct rcRaycastColumnVisitor
+{
+	const rcSpanBrickT<Layout>* brick;
+	const float* o;		///< Ray origin in grid units, y in span units.
+	const float* d;		///< Ray direction in grid units, y in span units.
+	float hitT;
+
+	bool operator()(const int x, const int y, const float ta, const float tb)
+	{
+		const float ya = o[1] + d[1]*ta;
+		const float yb = o[1] + d[1]*tb;
+		const float ymin = rcMin(ya, yb);
+		const float ymax = rcMax(ya, yb);
+
+		for (const rcSpanT<Layout>* s = brick->spans[rcBrickColumnIndex(x, y)]; s; s = s->next)
+		{
+			const float smin = (float)s->data.smin;
+			const float smax = (float)s->data.smax;
+			if (smin > ymax)
+				break;
+			if (smax < ymin)
+				continue;
+
+			// The ray overlaps the span inside this column, find where it enters.
+			if (ya >= smin && ya <= smax)
+				hitT = ta;
+			else if (ya > smax)
+				hitT = ta + (smax - ya) / d[1];
+			else
+				hitT = ta + (smin - ya) / d[1];
+			return true;
+		}
+		return false;
+	}
+};
+
+template<class Layout>
+struct rcRaycastBrickVisitor
+{
+	const rcHeightfieldT<Layout>* hf;
+	const float* o;
+	const float* d;
+	float hitT;
+
+	bool operator()(const int bx, const int by, const float ta, const float tb)
+	{
+		const rcSpanBrickT<Layout>* brick = hf->bricks[bx + by*hf->brickWidth];
+		if (!brick)
+			return false;
+
+		// Skip the brick if the ray passes above or below all of its spans.
+		const float ya = o[1] + d[1]*ta;
+		const float yb = o[1] + d[1]*tb;
+		if (!rcBrickOverlaps(*brick, (int)floorf(rcMin(ya, yb)), (int)ceilf(rcMax(ya, yb))))
+			return false;
+
+		const int x0 = bx << RC_BRICK_SHIFT;
+		const int y0 = by << RC_BRICK_SHIFT;
+		rcRaycastColumnVisitor<Layout> columns = { brick, o, d, 1.0f };
+		if (traverseCells(o, d, ta, tb, 1, x0, y0, rcMin(x0 + RC_BRICK_MASK, hf->width - 1), rcMin(y0 + RC_BRICK_MASK, hf->height - 1), columns))
+		{
+			hitT = columns.hitT;
+			return true;
+		}
+		return false;
+	}
+};
+
+/// @par
+///
+/// The ray is transformed into grid space, where columns are unit squares on
+/// the xz-plane and spans are measured in #rcHeightfield::ch units, then
+/// clipped against the heightfield bounds.
+template<class Layout>
+bool rcRaycastHeightfield(const rcHeightfieldT<Layout>& hf, const float* start, const float* end, float& hitT)
+{
+	const float ics = 1.0f / hf.cs;
+	const float ich = 1.0f / hf.ch;
+	const float o[3] = {
+		(start[0] - hf.bmin[0]) * ics,
+		(start[1] - hf.bmin[1]) * ich,
+		(start[2] - hf.bmin[2]) * ics };
+	const float d[3] = {
+		(end[0] - start[0]) * ics,
+		(end[1] - start[1]) * ich,
+		(end[2] - start[2]) * ics };
+
+	// Clip the segment to the grid.
+	float tmin = 0.0f;
+	float tmax = 1.0f;
+	const float bmax[3] = { (float)hf.width, (hf.bmax[1] - hf.bmin[1]) * ich, (float)hf.height };
+	for (int i = 0; i < 3; ++i)
+	{
+		if (rcAbs(d[i]) < 1e-8f)
+		{
+			if (o[i] < 0.0f || o[i] > bmax[i])
+				return false;
+			continue;
+		}
+		float t0 = (0.0f - o[i]) / d[i];
+		float t1 = (bmax[i] - o[i]) / d[i];
+		if (t0 > t1)
+		{
+			const float tmp = t0;
+			t0 = t1;
+			t1 = tmp;
+		}
+		tmin = rcMax(tmin, t0);
+		tmax = rcMin(tmax, t1);
+		if (tmin > tmax)
+			return false;
+	}
+
+	rcRaycastBrickVisitor<Layout> bricks = { &hf, o, d, 1.0f };
+	if (!traverseCells(o, d, tmin, tmax, RC_BRICK_SIZE, 0, 0, hf.brickWidth - 1, hf.brickHeight - 1, bricks))
+		return false;
+
+	hitT = bricks.hitT;
+	return true;
+}
+
+#define RC_INSTANTIATE_QUERIES(Layout) \
+	template bool rcQueryWalkableHeight<Layout>(const rcHeightfieldT<Layout>&, const float*, float&, float&); \
+	template bool rcRaycastHeightfield<Layout>(const rcHeightfieldT<Layout>&, const float*, const float*, float&);
+RC_FOR_EACH_SPAN_LAYOUT(RC_INSTANTIATE_QUERIES)
@@ -31,31 +31,65 @@
  *----------------------------------------------------------------------------
  */
 
-#include <corecrt_math.h>
+#include <float.h>
+#include <math.h>
+#include <string.h>
 
 #include "Recast.h"
 #include "RecastMath.h"
 #include "RecastAlloc.h"
+#include "RecastAssert.h"
+#include "RecastParallel.h"
 
 #define TEST_NEW_RASTERIZER (0)
 
-static rcSpan* allocSpan(rcHeightfield& hf)
+/// Optional rasterizer features, resolved at compile time by rasterizeTriImpl.
+enum rcRasterizeFeature
+{
+	RC_RASTERIZE_MERGE = 1,		///< Prefer the larger area when span tops are within flagMergeThr.
+	RC_RASTERIZE_FLAGS = 2,		///< Project spans to the bottom of the heightfield. (UE4)
+	RC_RASTERIZE_MASKS = 4,		///< Per-column masks for the projection flags. (UE4)
+};
+
+/// Picks the feature set a batch of triangles needs.
+static int rasterizeFeatures(const int flagMergeThr, const int rasterizationFlags, const int* rasterizationMasks)
+{
+	int features = 0;
+	if (flagMergeThr >= 0)
+		features |= RC_RASTERIZE_MERGE;
+	// Masks only ever clear flags, so they cost nothing without them.
+	if (rasterizationFlags)
+		features |= rasterizationMasks ? (RC_RASTERIZE_FLAGS | RC_RASTERIZE_MASKS) : RC_RASTERIZE_FLAGS;
+	return features;
+}
+
+/// Returns true if the span in column @p idx should be extended to the bottom of the heightfield.
+template<int Features>
+static inline bool projectSpanToBottom(const int rasterizationFlags, const int* rasterizationMasks, const int idx)
+{
+	if (Features & RC_RASTERIZE_MASKS)
+		return (rasterizationFlags & rasterizationMasks[idx]) != 0;
+	return (Features & RC_RASTERIZE_FLAGS) != 0;
+}
+
+template<class Layout>
+static rcSpanT<Layout>* allocSpan(rcHeightfieldT<Layout>& hf)
 {
 	// If running out of memory, allocate new page and update the freelist.
 	if (!hf.freelist || !hf.freelist->next)
 	{
 		// Create new page.
 		// Allocate memory for the new pool.
-		rcSpanPool* pool = (rcSpanPool*)rcAlloc(sizeof(rcSpanPool), RC_ALLOC_PERM);
+		rcSpanPoolT<Layout>* pool = (rcSpanPoolT<Layout>*)rcAlloc(sizeof(rcSpanPoolT<Layout>), RC_ALLOC_PERM);
 		if (!pool) return 0;
 		pool->next = 0;
 		// Add the pool into the list of pools.
 		pool->next = hf.pools;
 		hf.pools = pool;
 		// Add new items to the free list.
-		rcSpan* freelist = hf.freelist;
-		rcSpan* head = &pool->items[0];
-		rcSpan* it = &pool->items[RC_SPANS_PER_POOL];
+		rcSpanT<Layout>* freelist = hf.freelist;
+		rcSpanT<Layout>* head = &pool->items[0];
+		rcSpanT<Layout>* it = &pool->items[RC_SPANS_PER_POOL];
 		do
 		{
 			--it;
@@ -67,12 +101,13 @@ static rcSpan* allocSpan(rcHeightfield& hf)
 	}
 	
 	// Pop item from in front of the free list.
-	rcSpan* it = hf.freelist;
+	rcSpanT<Layout>* it = hf.freelist;
 	hf.freelist = hf.freelist->next;
 	return it;
 }
 
-static void freeSpan(rcHeightfield& hf, rcSpan* ptr)
+template<class Layout>
+static void freeSpan(rcHeightfieldT<Layout>& hf, rcSpanT<Layout>* ptr)
 {
 	if (!ptr) return;
 	// Add the node in front of the free list.
@@ -80,27 +115,13 @@ static void freeSpan(rcHeightfield& hf, rcSpan* ptr)
 	hf.freelist = ptr;
 }
 
-static void addSpan(rcHeightfield& hf, const int x, const int y,
-					const unsigned short smin, const unsigned short smax,
-					const unsigned char area, const int flagMergeThr)
+/// Inserts @p s into @p column, merging it with the spans it overlaps.
+template<class Layout, bool Merge>
+static inline void insertSpan(rcHeightfieldT<Layout>& hf, rcSpanT<Layout>** column, rcSpanT<Layout>* s,
+							  const int flagMergeThr)
 {
-	
-	int idx = x + y*hf.width;
-	
-	rcSpan* s = allocSpan(hf);
-	s->data.smin = smin;
-	s->data.smax = smax;
-	s->data.area = area;
-	s->next = 0;
-	
-	// Empty cell, add the first span.
-	if (!hf.spans[idx])
-	{
-		hf.spans[idx] = s;
-		return;
-	}
-	rcSpan* prev = 0;
-	rcSpan* cur = hf.spans[idx];
+	rcSpanT<Layout>* prev = 0;
+	rcSpanT<Layout>* cur = *column;
 	
 	// Insert and merge spans.
 	while (cur)
@@ -123,7 +144,7 @@ static void addSpan(rcHeightfield& hf, const int x, const int y,
 
 			// For spans whose tops are really close to each other, prefer walkable areas.
 			// This is done in order to remove aliasing (similar to z-fighting) on surfaces close to each other.
-			if (rcAbs((int)s->data.smax - (int)cur->data.smax) <= flagMergeThr)
+			if (Merge && rcAbs((int)s->data.smax - (int)cur->data.smax) <= flagMergeThr)
 			{
 				s->data.area = rcMax(s->data.area, cur->data.area);
 			}
@@ -142,12 +163,12 @@ static void addSpan(rcHeightfield& hf, const int x, const int y,
 			// @UE4 END
 			
 			// Remove current span.
-			rcSpan* next = cur->next;
+			rcSpanT<Layout>* next = cur->next;
 			freeSpan(hf, cur);
 			if (prev)
 				prev->next = next;
 			else
-				hf.spans[idx] = next;
+				*column = next;
 			cur = next;
 		}
 	}
@@ -160,12 +181,96 @@ static void addSpan(rcHeightfield& hf, const int x, const int y,
 	}
 	else
 	{
-		s->next = hf.spans[idx];
-		hf.spans[idx] = s;
+		s->next = *column;
+		*column = s;
+	}
+}
+
+template<class Layout, bool Merge>
+static bool addSpan(rcHeightfieldT<Layout>& hf, const int x, const int y,
+					const unsigned short smin, const unsigned short smax,
+					const unsigned char area, const int flagMergeThr)
+{
+	rcSpanT<Layout>** column = rcAllocColumn(hf, x, y);
+	if (!column)
+		return false;
+	
+	rcSpanT<Layout>* s = allocSpan(hf);
+	if (!s)
+		return false;
+	s->data.smin = smin;
+	s->data.smax = smax;
+	s->data.area = area;
+	s->next = 0;
+	
+	// Empty cell, add the first span.
+	if (!*column)
+	{
+		*column = s;
+		rcMarkOccupied(hf, x, y, smin, smax);
+		return true;
+	}
+
+	insertSpan<Layout, Merge>(hf, column, s, flagMergeThr);
+
+	rcMarkOccupied(hf, x, y, s->data.smin, s->data.smax);
+	return true;
+}
+
+/// Adds the same span to the columns [@p x0, @p x1] of row @p y, with the same result
+/// as calling addSpan on each of them. The brick is looked up and the occupancy marked
+/// once per run of columns sharing a brick, and empty columns take the span directly.
+template<class Layout, bool Merge>
+static bool addSpanRow(rcHeightfieldT<Layout>& hf, const int x0, const int x1, const int y,
+					   const unsigned short smin, const unsigned short smax,
+					   const unsigned char area, const int flagMergeThr)
+{
+	for (int bx = x0 >> RC_BRICK_SHIFT; bx <= (x1 >> RC_BRICK_SHIFT); ++bx)
+	{
+		const int runx0 = intMax(x0, bx << RC_BRICK_SHIFT);
+		const int runx1 = intMin(x1, (bx << RC_BRICK_SHIFT) + RC_BRICK_MASK);
+		if (!rcAllocColumn(hf, runx0, y))
+			return false;
+		rcSpanBrickT<Layout>& brick = *hf.bricks[rcBrickIndex(hf, runx0, y)];
+
+		for (int x = runx0; x <= runx1; ++x)
+		{
+			rcSpanT<Layout>* s = allocSpan(hf);
+			if (!s)
+			{
+				if (x > runx0)
+					rcMarkOccupiedRun(hf, runx0, x - 1, y, smin, smax);
+				return false;
+			}
+			s->data.smin = smin;
+			s->data.smax = smax;
+			s->data.area = area;
+			s->next = 0;
+
+			rcSpanT<Layout>** column = &brick.spans[rcBrickColumnIndex(x, y)];
+			if (!*column)
+				*column = s;
+			else
+				insertSpan<Layout, Merge>(hf, column, s, flagMergeThr);
+		}
+
+		// Merging only grows the new span over spans the brick already covers,
+		// so the bounds of the new span are enough.
+		rcMarkOccupiedRun(hf, runx0, runx1, y, smin, smax);
 	}
+	return true;
 }
 
-static inline void addFlatSpanSample(rcHeightfield& hf, const int x, const int y)
+template<class Layout>
+bool rcAddSpan(rcHeightfieldT<Layout>& hf, const int x, const int y,
+			   const unsigned short smin, const unsigned short smax,
+			   const unsigned char area, const int flagMergeThr)
+{
+	return addSpan<Layout, true>(hf, x, y, smin, smax, area, flagMergeThr);
+}
+
+template<class Layout>
+static inline void addFlatSpanSample(rcHeightfieldT<Layout>& hf, const int x, const int y)
 {
 	hf.RowExt[y + 1].MinCol = intMin(hf.RowExt[y + 1].MinCol, x);
 	hf.RowExt[y + 1].MaxCol = intMax(hf.RowExt[y + 1].MaxCol, x);
@@ -180,12 +285,57 @@ static inline void intersectX(const float* v0, const float* edge, float cx, floa
 	pnt[2] = v0[2] + t * edge[2];
 }
 
-static inline int SampleIndex(rcHeightfield const& hf, const int x, const int y)
+template<class Layout>
+static inline int SampleIndex(rcHeightfieldT<Layout> const& hf, const int x, const int y)
 {
+	const int idx = (x - hf.tempx0) + (y - hf.tempy0)*hf.tempstride;
 #if TEST_NEW_RASTERIZER
-	rcAssert(x >= -1 && x < hf.width + 1 && y >= -1 && y < hf.height + 1);
+	rcAssert(x >= hf.tempx0 && x < hf.tempx0 + hf.tempstride && y >= hf.tempy0 && idx < hf.tempspansSize);
 #endif
-	return x + 1 + (y + 1)*(hf.width + 2);
+	return idx;
+}
+
+/// Maps the temp spans onto the cells [x0-1, x1+1] x [y0-1, y1+1]. The edge walks
+/// may step one cell past the clamped triangle bounds.
+template<class Layout>
+static bool prepareTempSpans(rcHeightfieldT<Layout>& hf, const int x0, const int y0, const int x1, const int y1)
+{
+	const int stride = x1 - x0 + 3;
+	const int size = stride * (y1 - y0 + 3);
+	if (size > hf.tempspansSize)
+	{
+		const int newSize = intMax(size, hf.tempspansSize + hf.tempspansSize/2);
+		rcTempSpanT<Layout>* tempspans = (rcTempSpanT<Layout>*)rcAlloc(sizeof(rcTempSpanT<Layout>)*newSize, RC_ALLOC_PERM);
+		if (!tempspans)
+			return false;
+		rcFree(hf.tempspans);
+		hf.tempspans = tempspans;
+		hf.tempspansSize = newSize;
+		for (int i = 0; i < newSize; i++)
+		{
+			hf.tempspans[i].sminmax[0] = Layout::TempLimit;
+			hf.tempspans[i].sminmax[1] = -Layout::TempLimit;
+		}
+	}
+	hf.tempx0 = x0 - 1;
+	hf.tempy0 = y0 - 1;
+	hf.tempstride = stride;
+	return true;
+}
+
+/// Resets the temp spans of row @p y touched within [@p xmin, @p xmax].
+template<class Layout>
+static inline void resetTempSpans(rcHeightfieldT<Layout>& hf, const int y, const int xmin, const int xmax)
+{
+	const rcRowExt& Ext = hf.RowExt[y + 1];
+	const int xloop0 = intMax(Ext.MinCol, xmin);
+	const int xloop1 = intMin(Ext.MaxCol, xmax);
+	for (int x = xloop0; x <= xloop1; x++)
+	{
+		rcTempSpanT<Layout>& Temp = hf.tempspans[SampleIndex(hf, x, y)];
+		Temp.sminmax[0] = Layout::TempLimit;
+		Temp.sminmax[1] = -Layout::TempLimit;
+	}
 }
 
 static inline void intersectZ(const float* v0, const float* edge, float cz, float *pnt)
@@ -197,30 +347,156 @@ static inline void intersectZ(const float* v0, const float* edge, float cz, floa
 	pnt[2] = v0[2] + t * edge[2];
 }
 
-static inline void addSpanSample(rcHeightfield& hf, const int x, const int y, short int sint)
+template<class Layout>
+static inline void addSpanSample(rcHeightfieldT<Layout>& hf, const int x, const int y, typename Layout::TempType sint)
 {
 	addFlatSpanSample(hf, x, y);
 	int idx = SampleIndex(hf, x, y);
-	rcTempSpan& Temp = hf.tempspans[idx];
+	rcTempSpanT<Layout>& Temp = hf.tempspans[idx];
 
 	Temp.sminmax[0] = Temp.sminmax[0] > sint ? sint : Temp.sminmax[0];
 	Temp.sminmax[1] = Temp.sminmax[1] < sint ? sint : Temp.sminmax[1];
 }
 
-void rasterizeTri(const float* v0, const float* v1, const float* v2,
-						 const unsigned char area, rcHeightfield& hf,
-						 const float* bmin, const float* bmax,
-						 const float cs, const float ics, const float ich, 
-						 const int flagMergeThr,
-						 const int rasterizationFlags, /*UE4*/
-	                     const int* rasterizationMasks /*UE4*/)
+/// Twice the area, in cells, below which the reference rasterizer treats a cell as only grazed.
+static const float RC_GRAZE_AREA = 1e-4f;
+
+/// Keeps the part of the polygon where sign * (p[axis] - value) >= 0.
+static int clipPoly(const float* in, const int n, float* out, const int axis, const float value, const float sign)
+{
+	int m = 0;
+	for (int i = 0, j = n-1; i < n; j = i, ++i)
+	{
+		const float* a = &in[j*3];
+		const float* b = &in[i*3];
+		const float da = sign * (a[axis] - value);
+		const float db = sign * (b[axis] - value);
+		if ((da >= 0) != (db >= 0))
+		{
+			const float t = da / (da - db);
+			rcVlerp(&out[m*3], a, b, t);
+			m++;
+		}
+		if (db >= 0)
+		{
+			rcVcopy(&out[m*3], b);
+			m++;
+		}
+	}
+	return m;
+}
+
+template<class Layout>
+bool rcRasterizeTriCell(const float* v0, const float* v1, const float* v2, const rcHeightfieldT<Layout>& hf,
+						const int x, const int y, int& smin, int& smax)
+{
+	// A triangle clipped by four planes has at most seven vertices.
+	// Clip in cell units, so vertices fall into the same cells as in the rasterizer.
+	const float ics = 1.0f / hf.cs;
+	const float* verts[3] = { v0, v1, v2 };
+	float tri[3*3];
+	for (int i = 0; i < 3; ++i)
+	{
+		tri[i*3+0] = (verts[i][0] - hf.bmin[0])*ics;
+		tri[i*3+1] = verts[i][1];
+		tri[i*3+2] = (verts[i][2] - hf.bmin[2])*ics;
+	}
+	float buf[2][7*3];
+	memcpy(buf[0], tri, sizeof(tri));
+
+	const float cx0 = (float)x;
+	const float cz0 = (float)y;
+	int n = 3;
+	n = clipPoly(buf[0], n, buf[1], 0, cx0, 1.0f);
+	n = clipPoly(buf[1], n, buf[0], 0, cx0 + 1.0f, -1.0f);
+	n = clipPoly(buf[0], n, buf[1], 2, cz0, 1.0f);
+	n = clipPoly(buf[1], n, buf[0], 2, cz0 + 1.0f, -1.0f);
+	if (n < 3)
+		return false;
+
+	// Triangles only touching the cell along one of its sides belong to the neighbor.
+	const float side[4] = { cx0, cx0 + 1.0f, cz0, cz0 + 1.0f };
+	for (int k = 0; k < 4; ++k)
+	{
+		const int axis = k < 2 ? 0 : 2;
+		int on = 0;
+		for (int i = 0; i < n; ++i)
+			on += buf[0][i*3+axis] == side[k];
+		if (on == n)
+			return false;
+	}
+
+	// The same for a triangle with area that only grazes the cell within float rounding,
+	// on which side of the corner it lands is arbitrary. Walls have no area on the xz-plane
+	// and keep every cell they touch.
+	const float triArea = rcAbs(((v1[0]-v0[0])*(v2[2]-v0[2]) - (v2[0]-v0[0])*(v1[2]-v0[2]))*ics*ics);
+	float cellArea = 0.0f;
+	for (int i = 0, j = n-1; i < n; j = i, ++i)
+		cellArea += (buf[0][j*3+0] - cx0)*(buf[0][i*3+2] - cz0) - (buf[0][i*3+0] - cx0)*(buf[0][j*3+2] - cz0);
+	if (triArea > RC_GRAZE_AREA && rcAbs(cellArea) <= RC_GRAZE_AREA)
+		return false;
+
+	// The rasterizer samples a point on a grid line into the cells on both sides, except
+	// for the far corner of the cell: it only reaches this cell from the interior fill of
+	// the row above, which starts right of where the triangle crosses that row's line.
+	const float cx1 = cx0 + 1.0f;
+	const float cz1 = cz0 + 1.0f;
+	float rowx = FLT_MAX;
+	for (int i = 0, j = 2; i < 3; j = i, ++i)
+	{
+		const float* a = &tri[j*3];
+		const float* b = &tri[i*3];
+		if (a[2] == cz1)
+			rowx = rcMin(rowx, a[0]);
+		else if ((a[2] < cz1) != (b[2] < cz1) && b[2] != cz1)
+			rowx = rcMin(rowx, a[0] + (cz1 - a[2]) / (b[2] - a[2]) * (b[0] - a[0]));
+	}
+	const bool farCorner = rowx < cx1;
+
+	float ymin = FLT_MAX;
+	float ymax = -FLT_MAX;
+	for (int i = 0; i < n; ++i)
+	{
+		if (!farCorner && buf[0][i*3+0] == cx1 && buf[0][i*3+2] == cz1)
+			continue;
+		ymin = rcMin(ymin, buf[0][i*3+1]);
+		ymax = rcMax(ymax, buf[0][i*3+1]);
+	}
+	if (ymin > ymax)
+		return false;
+	ymin -= hf.bmin[1];
+	ymax -= hf.bmin[1];
+
+	// Skip the span if it is outside the heightfield bbox.
+	const float by = hf.bmax[1] - hf.bmin[1];
+	if (ymax < 0.0f || ymin > by)
+		return false;
+	ymin = rcMax(ymin, 0.0f);
+	ymax = rcMin(ymax, by);
+
+	const float ich = 1.0f / hf.ch;
+	smin = rcClamp((int)floorf(ymin * ich), 0, Layout::MaxHeight);
+	smax = rcClamp((int)ceilf(ymax * ich), smin+1, Layout::MaxHeight);
+	return true;
+}
+
+template<class Layout, int Features>
+static bool rasterizeTriImpl(const float* v0, const float* v1, const float* v2,
+							 const unsigned char area, rcHeightfieldT<Layout>& hf,
+							 const float* bmin, const float* bmax,
+							 const float cs, const float ics, const float ich, 
+							 const int flagMergeThr,
+							 const int rasterizationFlags, /*UE4*/
+							 const int* rasterizationMasks /*UE4*/)
 {
+	typedef typename Layout::TempType TempInt;
+	const bool Merge = (Features & RC_RASTERIZE_MERGE) != 0;
+
 	rcEdgeHit* const hfEdgeHits = hf.EdgeHits; //this prevents a static analysis warning
 
 	const int w = hf.width;
 	const int h = hf.height;
 	const float by = bmax[1] - bmin[1];
-	const int projectTriToBottom = rasterizationFlags; //UE4
 
 	int intverts[3][2];
 
@@ -237,7 +513,7 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 	int y1 = intMax(intverts[0][1], intMax(intverts[1][1], intverts[2][1]));
 
 	if (x1 < 0 || x0 >= w || y1 < 0 || y0 >= h)
-		return;
+		return true;
 
 	// Calculate min and max of the triangle
 
@@ -246,8 +522,8 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 	triangle_smin -= bmin[1];
 	triangle_smax -= bmin[1];
 	// Skip the span if it is outside the heightfield bbox
-	if (triangle_smax < 0.0f) return;
-	if (triangle_smin > by) return;
+	if (triangle_smax < 0.0f) return true;
+	if (triangle_smin > by) return true;
 
 	if (x0 == x1 && y0 == y1)
 	{
@@ -256,20 +532,18 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 		if (triangle_smax > by) triangle_smax = by;
 
 		// Snap the span to the heightfield height grid.
-		unsigned short triangle_ismin = (unsigned short)rcClamp((int)floorf(triangle_smin * ich), 0, RC_SPAN_MAX_HEIGHT);
-		unsigned short triangle_ismax = (unsigned short)rcClamp((int)ceilf(triangle_smax * ich), (int)triangle_ismin+1, RC_SPAN_MAX_HEIGHT);
-		const int projectSpanToBottom = rasterizationMasks != nullptr ? (projectTriToBottom & rasterizationMasks[x0+y0*w]) : projectTriToBottom;	//UE4
-		if (projectSpanToBottom) //UE4
+		unsigned short triangle_ismin = (unsigned short)rcClamp((int)floorf(triangle_smin * ich), 0, Layout::MaxHeight);
+		unsigned short triangle_ismax = (unsigned short)rcClamp((int)ceilf(triangle_smax * ich), (int)triangle_ismin+1, Layout::MaxHeight);
+		if (projectSpanToBottom<Features>(rasterizationFlags, rasterizationMasks, x0+y0*w)) //UE4
 		{
 			triangle_ismin = 0; //UE4
 		}
 
-		addSpan(hf, x0, y0, triangle_ismin, triangle_ismax, area, flagMergeThr);
-		return;
+		return addSpan<Layout, Merge>(hf, x0, y0, triangle_ismin, triangle_ismax, area, flagMergeThr);
 	}
 
-	const short int triangle_ismin = (short int)rcClamp((int)floorf(triangle_smin * ich), -32000, 32000);
-	const short int triangle_ismax = (short int)rcClamp((int)floorf(triangle_smax * ich), -32000, 32000);
+	const TempInt triangle_ismin = (TempInt)rcClamp((int)floorf(triangle_smin * ich), -Layout::TempLimit, Layout::TempLimit);
+	const TempInt triangle_ismax = (TempInt)rcClamp((int)floorf(triangle_smax * ich), -Layout::TempLimit, Layout::TempLimit);
 
 	x0 = intMax(x0, 0);
 	int x1_edge = intMin(x1, w);
@@ -277,6 +551,9 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 	y0 = intMax(y0, 0);
 	int y1_edge = intMin(y1, h);
 	y1 = intMin(y1, h - 1);
+
+	// An allocation failure still finishes the triangle, so the temp spans are reset for the next one.
+	bool ok = true;
 	
 	float edges[6][3];
 
@@ -400,12 +677,12 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 			}
 		}
 
-		if (rasterizationMasks == nullptr) //UE4
+		if (!(Features & RC_RASTERIZE_MASKS)) //UE4
 		{
 			// Snap the span to the heightfield height grid.
-			unsigned short triangle_ismin_clamp = (unsigned short)rcClamp((int)triangle_ismin, 0, RC_SPAN_MAX_HEIGHT);
-			const unsigned short triangle_ismax_clamp = (unsigned short)rcClamp((int)triangle_ismax, (int)triangle_ismin_clamp+1, RC_SPAN_MAX_HEIGHT);
-			if (projectTriToBottom) //UE4
+			unsigned short triangle_ismin_clamp = (unsigned short)rcClamp((int)triangle_ismin, 0, Layout::MaxHeight);
+			const unsigned short triangle_ismax_clamp = (unsigned short)rcClamp((int)triangle_ismax, (int)triangle_ismin_clamp+1, Layout::MaxHeight);
+			if (Features & RC_RASTERIZE_FLAGS) //UE4
 			{
 				triangle_ismin_clamp = 0; //UE4
 			}
@@ -414,9 +691,10 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 			{
 				int xloop0 = intMax(hf.RowExt[y + 1].MinCol, x0);
 				int xloop1 = intMin(hf.RowExt[y + 1].MaxCol, x1);
-				for (int x = xloop0; x <= xloop1; x++)
+				if (xloop0 <= xloop1)
 				{
-					addSpan(hf, x, y, triangle_ismin_clamp, triangle_ismax_clamp, area, flagMergeThr);
+					if (!addSpanRow<Layout, Merge>(hf, xloop0, xloop1, y, triangle_ismin_clamp, triangle_ismax_clamp, area, flagMergeThr))
+						ok = false;
 				}
 
 				// reset for next triangle
@@ -434,14 +712,14 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 				for (int x = xloop0; x <= xloop1; x++)
 				{
 					// Snap the span to the heightfield height grid.
-					unsigned short triangle_ismin_clamp = (unsigned short)rcClamp((int)triangle_ismin, 0, RC_SPAN_MAX_HEIGHT);
-					const unsigned short triangle_ismax_clamp = (unsigned short)rcClamp((int)triangle_ismax, (int)triangle_ismin_clamp+1, RC_SPAN_MAX_HEIGHT);
-					const int projectSpanToBottom = projectTriToBottom & rasterizationMasks[x+y*w];		//UE4
-					if (projectSpanToBottom) //UE4
+					unsigned short triangle_ismin_clamp = (unsigned short)rcClamp((int)triangle_ismin, 0, Layout::MaxHeight);
+					const unsigned short triangle_ismax_clamp = (unsigned short)rcClamp((int)triangle_ismax, (int)triangle_ismin_clamp+1, Layout::MaxHeight);
+					if (projectSpanToBottom<Features>(rasterizationFlags, rasterizationMasks, x+y*w)) //UE4
 					{
 						triangle_ismin_clamp = 0; //UE4
 					}
-					addSpan(hf, x, y, triangle_ismin_clamp, triangle_ismax_clamp, area, flagMergeThr);
+					if (!addSpan<Layout, Merge>(hf, x, y, triangle_ismin_clamp, triangle_ismax_clamp, area, flagMergeThr))
+						ok = false;
 				}
 
 				// reset for next triangle
@@ -454,6 +732,12 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 	else
 	{
 		//non-flat case
+		if (!prepareTempSpans(hf, x0, y0, x1, y1))
+			return false;
+
+		// Clip the spans to the top of the heightfield bbox, as the flat and single cell cases do.
+		const int topHeight = rcClamp((int)ceilf(by * ich), 1, Layout::MaxHeight);
+
 		for (int basevert = 0; basevert < 3; basevert++)
 		{
 			int othervert = basevert == 2 ? 0 : basevert + 1;
@@ -469,7 +753,7 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 			if (intverts[basevert][0] >= x0 && intverts[basevert][0] <= x1 && intverts[basevert][1] >= y0 && intverts[basevert][1] <= y1)
 			{
 				float sfloat = vertarray[basevert][1] - bmin[1];
-				short int sint = (short int)rcClamp((int)floorf(sfloat * ich), -32000, 32000);
+				TempInt sint = (TempInt)rcClamp((int)floorf(sfloat * ich), -Layout::TempLimit, Layout::TempLimit);
 	#if TEST_NEW_RASTERIZER
 				rcAssert(sint >= triangle_ismin - 1 && sint <= triangle_ismax + 1);
 	#endif
@@ -507,7 +791,7 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 					if (y >= y0 && y <= y1)
 					{
 						float sfloat = temppnt[1] - bmin[1];
-						short int sint = (short int)rcClamp((int)floorf(sfloat * ich), -32000, 32000);
+						TempInt sint = (TempInt)rcClamp((int)floorf(sfloat * ich), -Layout::TempLimit, Layout::TempLimit);
 #if TEST_NEW_RASTERIZER
 						rcAssert(sint >= triangle_ismin - 1 && sint <= triangle_ismax + 1);
 #endif
@@ -548,7 +832,7 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 						if (x >= x0 && x <= x1)
 						{
 							float sfloat = Inter[i][1] - bmin[1];
-							short int sint = (short int)rcClamp((int)floorf(sfloat * ich), -32000, 32000);
+							TempInt sint = (TempInt)rcClamp((int)floorf(sfloat * ich), -Layout::TempLimit, Layout::TempLimit);
 #if TEST_NEW_RASTERIZER
 							rcAssert(sint >= triangle_ismin - 1 && sint <= triangle_ismax + 1);
 #endif
@@ -577,7 +861,7 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 						}
 						for (int x = xloop0; x <= xloop1; x++, sfloat += ds)
 						{
-							short int sint = (short int)rcClamp((int)floorf(sfloat * ich), -32000, 32000);
+							TempInt sint = (TempInt)rcClamp((int)floorf(sfloat * ich), -Layout::TempLimit, Layout::TempLimit);
 #if TEST_NEW_RASTERIZER
 							rcAssert(sint >= triangle_ismin - 1 && sint <= triangle_ismax + 1);
 #endif
@@ -600,66 +884,317 @@ void rasterizeTri(const float* v0, const float* v1, const float* v2,
 			for (int x = xloop0; x <= xloop1; x++)
 			{
 				int idx = SampleIndex(hf, x, y);
-				rcTempSpan& Temp = hf.tempspans[idx];
+				rcTempSpanT<Layout>& Temp = hf.tempspans[idx];
 
-				short int smin = Temp.sminmax[0];
-				short int smax = Temp.sminmax[1];
-	#if TEST_NEW_RASTERIZER
-				short int tsmin = Temp.sminmax[0];
-				short int tsmax = Temp.sminmax[1];
-	#endif
+				TempInt smin = Temp.sminmax[0];
+				TempInt smax = Temp.sminmax[1];
 				// reset for next triangle
-				Temp.sminmax[0] = 32000;
-				Temp.sminmax[1] = -32000;
+				Temp.sminmax[0] = Layout::TempLimit;
+				Temp.sminmax[1] = -Layout::TempLimit;
 
 				// Skip the span if it is outside the heightfield bbox
-				if (smin >= RC_SPAN_MAX_HEIGHT || smax < 0) continue;
+				if (smin >= topHeight || smax < 0) continue;
 
 				smin = intMax(smin, 0);
-				smax = intMin(intMax(smax,smin+1), RC_SPAN_MAX_HEIGHT);
-				const int projectSpanToBottom = rasterizationMasks != nullptr ? (projectTriToBottom & rasterizationMasks[x+y*w]) : projectTriToBottom; //UE4
-				if (projectSpanToBottom) //UE4
-				{
-					smin = 0; //UE4
-				}
-
+				smax = intMin(intMax(smax,smin+1), topHeight);
 	#if TEST_NEW_RASTERIZER
 				{
-					short int outsmin, outsmax;
-					rasterizeTriTest(v0, v1, v2, x, y, 
-						outsmin, outsmax, 
-						area, hf,
-						bmin, bmax,
-						cs, ics, ich,
-						flagMergeThr);
-					const int tol = 1;
-					if (outsmin > smin + tol || outsmin < smin - tol ||
-						outsmax > smax + tol || outsmax < smax - tol
-						)
-					{
-						Temp.sminmax[0] = 32000;
-						Temp.sminmax[1] = -32000;
-						rasterizeTriTest(v0, v1, v2, x, y, 
-							outsmin, outsmax, 
-							area, hf,
-							bmin, bmax,
-							cs, ics, ich,
-							flagMergeThr);
-						if (outsmin != 8191)
-						{
-							Temp.sminmax[0] = 32000;
-							Temp.sminmax[1] = -32000;
-						}
-					}
-
+					// The samples are snapped down, the reference rounds its top up.
+					int refmin, refmax;
+					if (rcRasterizeTriCell(v0, v1, v2, hf, x, y, refmin, refmax))
+						rcAssert(rcAbs(refmin - (int)smin) <= 1 && rcAbs(refmax - (int)smax) <= 1);
 				}
 	#endif
-				addSpan(hf, x, y, smin, smax, area, flagMergeThr);
+				if (projectSpanToBottom<Features>(rasterizationFlags, rasterizationMasks, x+y*w)) //UE4
+				{
+					smin = 0; //UE4
+				}
+
+				if (!addSpan<Layout, Merge>(hf, x, y, smin, smax, area, flagMergeThr))
+					ok = false;
 			}
 
-			// reset for next triangle
+			// reset for next triangle, including the border columns that were not consumed
+			resetTempSpans(hf, y, x0 - 1, x0 - 1);
+			resetTempSpans(hf, y, x1 + 1, x1 + 1);
+			hf.RowExt[y + 1].MinCol = hf.width + 2;
+			hf.RowExt[y + 1].MaxCol = -2;
+		}
+
+		// The rows just outside the clamped bounds are only touched when the triangle
+		// leaves the heightfield; they map to other cells for the next triangle.
+		const int borderRows[2] = { y0 - 1, y1 + 1 };
+		for (int i = 0; i < 2; i++)
+		{
+			const int y = borderRows[i];
+			resetTempSpans(hf, y, x0 - 1, x1 + 1);
 			hf.RowExt[y + 1].MinCol = hf.width + 2;
 			hf.RowExt[y + 1].MaxCol = -2;
 		}
 	}
-}
\ No newline at end of file
+	return ok;
+}
+
+/// Returns @p Func<Layout, Features> for the feature set picked at run time.
+#define RC_DISPATCH_RASTERIZE_FEATURES(features, Func, Layout, args) \
+	switch (features) \
+	{ \
+	case 0:	return Func<Layout, 0> args; \
+	case RC_RASTERIZE_MERGE:	return Func<Layout, RC_RASTERIZE_MERGE> args; \
+	case RC_RASTERIZE_FLAGS:	return Func<Layout, RC_RASTERIZE_FLAGS> args; \
+	case RC_RASTERIZE_MERGE | RC_RASTERIZE_FLAGS:	return Func<Layout, RC_RASTERIZE_MERGE | RC_RASTERIZE_FLAGS> args; \
+	case RC_RASTERIZE_FLAGS | RC_RASTERIZE_MASKS:	return Func<Layout, RC_RASTERIZE_FLAGS | RC_RASTERIZE_MASKS> args; \
+	default:	return Func<Layout, RC_RASTERIZE_MERGE | RC_RASTERIZE_FLAGS | RC_RASTERIZE_MASKS> args; \
+	}
+
+template<class Layout>
+bool rasterizeTri(const float* v0, const float* v1, const float* v2,
+						 const unsigned char area, rcHeightfieldT<Layout>& hf,
+						 const float* bmin, const float* bmax,
+						 const float cs, const float ics, const float ich, 
+						 const int flagMergeThr,
+						 const int rasterizationFlags, /*UE4*/
+	                     const int* rasterizationMasks /*UE4*/)
+{
+	const int features = rasterizeFeatures(flagMergeThr, rasterizationFlags, rasterizationMasks);
+	RC_DISPATCH_RASTERIZE_FEATURES(features, rasterizeTriImpl, Layout,
+		(v0, v1, v2, area, hf, bmin, bmax, cs, ics, ich, flagMergeThr, rasterizationFlags, rasterizationMasks))
+}
+
+template<class Layout, int Features>
+static bool rasterizeTrianglesImpl(rcContext* ctx, const float* verts, const int* tris, const unsigned char* areas, const int nt,
+								   rcHeightfieldT<Layout>& solid, const int flagMergeThr,
+								   const int rasterizationFlags, const int* rasterizationMasks)
+{
+	const float ics = 1.0f/solid.cs;
+	const float ich = 1.0f/solid.ch;
+	for (int i = 0; i < nt; ++i)
+	{
+		const float* v0 = &verts[tris[i*3+0]*3];
+		const float* v1 = &verts[tris[i*3+1]*3];
+		const float* v2 = &verts[tris[i*3+2]*3];
+		if (!rasterizeTriImpl<Layout, Features>(v0, v1, v2, areas[i], solid, solid.bmin, solid.bmax, solid.cs, ics, ich,
+												flagMergeThr, rasterizationFlags, rasterizationMasks))
+		{
+			ctx->log(RC_LOG_ERROR, "rcRasterizeTriangles: Out of memory.");
+			return false;
+		}
+	}
+	return true;
+}
+
+template<class Layout>
+bool rcRasterizeTriangles(rcContext* ctx, const float* verts, const int /*nv*/,
+						  const int* tris, const unsigned char* areas, const int nt,
+						  rcHeightfieldT<Layout>& solid, const int flagMergeThr,
+						  const int rasterizationFlags, const int* rasterizationMasks)
+{
+	rcAssert(ctx);
+
+	const int features = rasterizeFeatures(flagMergeThr, rasterizationFlags, rasterizationMasks);
+	RC_DISPATCH_RASTERIZE_FEATURES(features, rasterizeTrianglesImpl, Layout,
+		(ctx, verts, tris, areas, nt, solid, flagMergeThr, rasterizationFlags, rasterizationMasks))
+}
+
+/// Triangles per chunk of the radix sort, each chunk keeps its own digit histogram.
+static const int RC_SORT_CHUNK = 1<<14;
+static const int RC_SORT_RADIX_BITS = 8;
+static const int RC_SORT_RADIX = 1<<RC_SORT_RADIX_BITS;
+
+/// The radix sort runs one task item per chunk of triangles.
+struct rcSortTask
+{
+	const float* verts;
+	const int* tris;
+	const unsigned char* areas;
+	int nt;
+	float bmin[2];
+	float ics;
+	int maxX;
+	int maxZ;
+	int cellShift;			///< Drops low cell bits, so both cell coordinates fit in 16 bits.
+	unsigned int* keys[2];
+	int* order[2];
+	int src;				///< The buffer the current pass reads from.
+	int digitShift;			///< The key bits the current pass sorts by.
+	unsigned int* histograms;	///< Digit counts of every chunk, then its scatter offsets. [Size: nchunks*#RC_SORT_RADIX]
+	int* sortedTris;
+	unsigned char* sortedAreas;
+};
+
+/// Spreads the low 16 bits of @p v to the even bits.
+static inline unsigned int spreadBits(unsigned int v)
+{
+	v &= 0xffff;
+	v = (v | (v << 8)) & 0x00ff00ff;
+	v = (v | (v << 4)) & 0x0f0f0f0f;
+	v = (v | (v << 2)) & 0x33333333;
+	v = (v | (v << 1)) & 0x55555555;
+	return v;
+}
+
+static void computeSortKeys(void* userData, int begin, int end)
+{
+	rcSortTask& task = *(rcSortTask*)userData;
+	for (int chunk = begin; chunk < end; ++chunk)
+	{
+		const int i1 = rcMin((chunk + 1)*RC_SORT_CHUNK, task.nt);
+		for (int i = chunk*RC_SORT_CHUNK; i < i1; ++i)
+		{
+			const float* v0 = &task.verts[task.tris[i*3+0]*3];
+			const float* v1 = &task.verts[task.tris[i*3+1]*3];
+			const float* v2 = &task.verts[task.tris[i*3+2]*3];
+			const float cx = (v0[0] + v1[0] + v2[0])*(1.0f/3.0f);
+			const float cz = (v0[2] + v1[2] + v2[2])*(1.0f/3.0f);
+			const int x = rcClamp((int)((cx - task.bmin[0])*task.ics), 0, task.maxX) >> task.cellShift;
+			const int z = rcClamp((int)((cz - task.bmin[1])*task.ics), 0, task.maxZ) >> task.cellShift;
+			task.keys[0][i] = spreadBits((unsigned int)x) | (spreadBits((unsigned int)z) << 1);
+			task.order[0][i] = i;
+		}
+	}
+}
+
+static void countSortDigits(void* userData, int begin, int end)
+{
+	rcSortTask& task = *(rcSortTask*)userData;
+	const unsigned int* keys = task.keys[task.src];
+	for (int chunk = begin; chunk < end; ++chunk)
+	{
+		unsigned int* hist = &task.histograms[chunk*RC_SORT_RADIX];
+		memset(hist, 0, sizeof(unsigned int)*RC_SORT_RADIX);
+		const int i1 = rcMin((chunk + 1)*RC_SORT_CHUNK, task.nt);
+		for (int i = chunk*RC_SORT_CHUNK; i < i1; ++i)
+			hist[(keys[i] >> task.digitShift) & (RC_SORT_RADIX - 1)]++;
+	}
+}
+
+/// Moves every chunk to its offsets in the other buffer, keeping the order within a digit.
+static void scatterSortDigits(void* userData, int begin, int end)
+{
+	rcSortTask& task = *(rcSortTask*)userData;
+	const unsigned int* keys = task.keys[task.src];
+	const int* order = task.order[task.src];
+	unsigned int* dstKeys = task.keys[1 - task.src];
+	int* dstOrder = task.order[1 - task.src];
+	for (int chunk = begin; chunk < end; ++chunk)
+	{
+		unsigned int* offsets = &task.histograms[chunk*RC_SORT_RADIX];
+		const int i1 = rcMin((chunk + 1)*RC_SORT_CHUNK, task.nt);
+		for (int i = chunk*RC_SORT_CHUNK; i < i1; ++i)
+		{
+			const unsigned int dst = offsets[(keys[i] >> task.digitShift) & (RC_SORT_RADIX - 1)]++;
+			dstKeys[dst] = keys[i];
+			dstOrder[dst] = order[i];
+		}
+	}
+}
+
+static void gatherSortedTriangles(void* userData, int begin, int end)
+{
+	rcSortTask& task = *(rcSortTask*)userData;
+	const int* order = task.order[task.src];
+	for (int chunk = begin; chunk < end; ++chunk)
+	{
+		const int i1 = rcMin((chunk + 1)*RC_SORT_CHUNK, task.nt);
+		for (int i = chunk*RC_SORT_CHUNK; i < i1; ++i)
+		{
+			const int j = order[i];
+			task.sortedTris[i*3+0] = task.tris[j*3+0];
+			task.sortedTris[i*3+1] = task.tris[j*3+1];
+			task.sortedTris[i*3+2] = task.tris[j*3+2];
+			task.sortedAreas[i] = task.areas[j];
+		}
+	}
+}
+
+/// @par
+///
+/// A least significant digit radix sort over 32-bit Morton keys. Every pass counts
+/// the digits of each chunk in parallel, turns the counts into scatter offsets, and
+/// scatters the chunks in parallel, which keeps the sort stable. Passes whose digit
+/// is the same for every triangle are skipped, which drops the high passes on grids
+/// up to 256 cells wide.
+///
+/// @see rcRasterizeTriangles
+bool rcSortTrianglesMorton(const float* verts, int* tris, unsigned char* areas, const int nt,
+						   const float* bmin, const float cs, const int width, const int height)
+{
+	if (nt <= 1)
+		return true;
+
+	const int nchunks = (nt + RC_SORT_CHUNK - 1) / RC_SORT_CHUNK;
+	rcScopedDelete<unsigned int> keys0((int)nt), keys1((int)nt);
+	rcScopedDelete<int> order0((int)nt), order1((int)nt);
+	rcScopedDelete<unsigned int> histograms(nchunks*RC_SORT_RADIX);
+	rcScopedDelete<int> sortedTris(nt*3);
+	rcScopedDelete<unsigned char> sortedAreas((int)nt);
+	if (!keys0 || !keys1 || !order0 || !order1 || !histograms || !sortedTris || !sortedAreas)
+		return false;
+
+	rcSortTask task;
+	task.verts = verts;
+	task.tris = tris;
+	task.areas = areas;
+	task.nt = nt;
+	task.bmin[0] = bmin[0];
+	task.bmin[1] = bmin[2];
+	task.ics = 1.0f / cs;
+	task.maxX = rcMax(width - 1, 0);
+	task.maxZ = rcMax(height - 1, 0);
+	task.cellShift = 0;
+	while ((rcMax(task.maxX, task.maxZ) >> task.cellShift) > 0xffff)
+		task.cellShift++;
+	task.keys[0] = keys0;
+	task.keys[1] = keys1;
+	task.order[0] = order0;
+	task.order[1] = order1;
+	task.src = 0;
+	task.histograms = histograms;
+	task.sortedTris = sortedTris;
+	task.sortedAreas = sortedAreas;
+
+	rcParallelFor(nchunks, 1, computeSortKeys, &task);
+
+	for (task.digitShift = 0; task.digitShift < 32; task.digitShift += RC_SORT_RADIX_BITS)
+	{
+		rcParallelFor(nchunks, 1, countSortDigits, &task);
+
+		// Each digit starts after all smaller digits, and within a digit the chunks follow each other.
+		unsigned int offset = 0;
+		bool uniform = false;
+		for (int digit = 0; digit < RC_SORT_RADIX && !uniform; ++digit)
+		{
+			unsigned int total = 0;
+			for (int chunk = 0; chunk < nchunks; ++chunk)
+			{
+				unsigned int& count = histograms[chunk*RC_SORT_RADIX + digit];
+				const unsigned int n = count;
+				count = offset + total;
+				total += n;
+			}
+			uniform = total == (unsigned int)nt;
+			offset += total;
+		}
+		if (uniform)
+			continue;
+
+		rcParallelFor(nchunks, 1, scatterSortDigits, &task);
+		task.src = 1 - task.src;
+	}
+
+	rcParallelFor(nchunks, 1, gatherSortedTriangles, &task);
+	memcpy(tris, sortedTris, sizeof(int)*nt*3);
+	memcpy(areas, sortedAreas, sizeof(unsigned char)*nt);
+	return true;
+}
+
+#define RC_INSTANTIATE_RASTERIZATION(Layout) \
+	template bool rasterizeTri<Layout>(const float*, const float*, const float*, const unsigned char, rcHeightfieldT<Layout>&, \
+		const float*, const float*, const float, const float, const float, const int, const int, const int*); \
+	template bool rcAddSpan<Layout>(rcHeightfieldT<Layout>&, const int, const int, const unsigned short, const unsigned short, \
+		const unsigned char, const int); \
+	template bool rcRasterizeTriCell<Layout>(const float*, const float*, const float*, const rcHeightfieldT<Layout>&, \
+		const int, const int, int&, int&); \
+	template bool rcRasterizeTriangles<Layout>(rcContext*, const float*, const int, const int*, const unsigned char*, const int, \
+		rcHeightfieldT<Layout>&, const int, const int, const int*);
+RC_FOR_EACH_SPAN_LAYOUT(RC_INSTANTIATE_RASTERIZATION)
@@ -0,0 +1,333 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+#include "Recast.h"
+#include "RecastAlloc.h"
+#include "RecastAssert.h"
+#include "RecastMath.h"
+#include "RecastParallel.h"
+#include <string.h>
+
+/// Regions are flooded in square tiles of cells, one task item per tile.
+static const int RC_REGION_TILE = 64;
+
+struct rcRegionTask
+{
+	rcColumnHeightfield* chf;
+	unsigned int* labels;		///< The region of every span, numbered from 1 within its tile.
+	unsigned int* tileFirst;	///< The regions of each tile, then the first global region of each tile. [Size: tiles + 1]
+	unsigned int* parents;		///< The union-find parent of every global region. [Size: regions + 1]
+	const unsigned short* ids;	///< The region id of every global region. [Size: regions + 1]
+	int tilesX;
+	int tilesY;
+};
+
+/// Returns the tile holding the column at (@p x, @p y).
+static inline int tileIndex(const rcRegionTask& task, int x, int y)
+{
+	return x/RC_REGION_TILE + (y/RC_REGION_TILE)*task.tilesX;
+}
+
+/// Floods the walkable spans of each tile into regions that stop at the tile border.
+static void floodTiles(void* userData, int begin, int end)
+{
+	const rcRegionTask& task = *(const rcRegionTask*)userData;
+	const rcColumnHeightfield& chf = *task.chf;
+	rcIntArray stack;
+	for (int t = begin; t < end; ++t)
+	{
+		const int x0 = (t % task.tilesX)*RC_REGION_TILE;
+		const int y0 = (t / task.tilesX)*RC_REGION_TILE;
+		const int x1 = rcMin(x0 + RC_REGION_TILE, chf.width);
+		const int y1 = rcMin(y0 + RC_REGION_TILE, chf.height);
+		unsigned int count = 0;
+		for (int y = y0; y < y1; ++y)
+		{
+			for (int x = x0; x < x1; ++x)
+			{
+				const int c = x + y*chf.width;
+				for (unsigned int i = chf.cells[c]; i < chf.cells[c + 1]; ++i)
+				{
+					if (chf.areas[i] == RC_NULL_AREA || task.labels[i] != 0)
+						continue;
+
+					task.labels[i] = ++count;
+					stack.resize(0);
+					stack.push(x);
+					stack.push(y);
+					stack.push((int)i);
+					while (stack.size() > 0)
+					{
+						const unsigned int si = (unsigned int)stack.pop();
+						const int sy = stack.pop();
+						const int sx = stack.pop();
+						for (int dir = 0; dir < 4; ++dir)
+						{
+							const int nx = sx + rcGetDirOffsetX(dir);
+							const int ny = sy + rcGetDirOffsetY(dir);
+							if (nx < x0 || ny < y0 || nx >= x1 || ny >= y1)
+								continue;
+							const int ni = rcGetColumnNeighbour(chf, sx, sy, si, dir);
+							if (ni < 0 || chf.areas[ni] != chf.areas[si] || task.labels[ni] != 0)
+								continue;
+							task.labels[ni] = count;
+							stack.push(nx);
+							stack.push(ny);
+							stack.push(ni);
+						}
+					}
+				}
+			}
+		}
+		task.tileFirst[t] = count;
+	}
+}
+
+/// Replaces the tile local regions of each tile with their region ids.
+static void relabelTiles(void* userData, int begin, int end)
+{
+	const rcRegionTask& task = *(const rcRegionTask*)userData;
+	rcColumnHeightfield& chf = *task.chf;
+	for (int t = begin; t < end; ++t)
+	{
+		const int x0 = (t % task.tilesX)*RC_REGION_TILE;
+		const int y0 = (t / task.tilesX)*RC_REGION_TILE;
+		const int x1 = rcMin(x0 + RC_REGION_TILE, chf.width);
+		const int y1 = rcMin(y0 + RC_REGION_TILE, chf.height);
+		for (int y = y0; y < y1; ++y)
+		{
+			const unsigned int first = chf.cells[x0 + y*chf.width];
+			const unsigned int last = chf.cells[x1 + y*chf.width];
+			for (unsigned int i = first; i < last; ++i)
+				chf.regs[i] = task.labels[i] ? task.ids[task.tileFirst[t] + task.labels[i]] : 0;
+		}
+	}
+}
+
+static unsigned int findRoot(unsigned int* parents, unsigned int r)
+{
+	while (parents[r] != r)
+	{
+		parents[r] = parents[parents[r]];
+		r = parents[r];
+	}
+	return r;
+}
+
+/// Joins two regions, keeping the lower one as the root so roots come first in order.
+static void joinRegions(unsigned int* parents, unsigned int a, unsigned int b)
+{
+	a = findRoot(parents, a);
+	b = findRoot(parents, b);
+	if (a < b)
+		parents[b] = a;
+	else if (b < a)
+		parents[a] = b;
+}
+
+/// Joins the regions of each tile that a connection links against the direction it was
+/// flooded in. A span only connects to the lowest span it can step to, so a span can be
+/// reached from a neighbour it does not connect back to, and the flood misses the link
+/// if it started from the far side. The regions of a tile are a range of their own, so
+/// tiles join in parallel.
+static void joinTileRegions(void* userData, int begin, int end)
+{
+	const rcRegionTask& task = *(const rcRegionTask*)userData;
+	const rcColumnHeightfield& chf = *task.chf;
+	for (int t = begin; t < end; ++t)
+	{
+		const int x0 = (t % task.tilesX)*RC_REGION_TILE;
+		const int y0 = (t / task.tilesX)*RC_REGION_TILE;
+		const int x1 = rcMin(x0 + RC_REGION_TILE, chf.width);
+		const int y1 = rcMin(y0 + RC_REGION_TILE, chf.height);
+		const unsigned int base = task.tileFirst[t];
+		for (int y = y0; y < y1; ++y)
+		{
+			for (int x = x0; x < x1; ++x)
+			{
+				const int c = x + y*chf.width;
+				for (unsigned int i = chf.cells[c]; i < chf.cells[c + 1]; ++i)
+				{
+					if (task.labels[i] == 0)
+						continue;
+					for (int dir = 0; dir < 4; ++dir)
+					{
+						const int nx = x + rcGetDirOffsetX(dir);
+						const int ny = y + rcGetDirOffsetY(dir);
+						if (nx < x0 || ny < y0 || nx >= x1 || ny >= y1)
+							continue;
+						const int ni = rcGetColumnNeighbour(chf, x, y, i, dir);
+						if (ni < 0 || task.labels[ni] == 0 || task.labels[ni] == task.labels[i] ||
+							chf.areas[ni] != chf.areas[i])
+							continue;
+						joinRegions(task.parents, base + task.labels[i], base + task.labels[ni]);
+					}
+				}
+			}
+		}
+	}
+}
+
+/// @par
+///
+/// A region holds the walkable spans of one area that are connected through
+/// #rcBuildColumnConnections, in either direction, so the regions are the same as
+/// those of a serial flood fill over the connections taken both ways. Every tile is
+/// flooded on its own, then the regions linked within a tile against the flood
+/// direction and the regions touching across the tile borders are joined with a
+/// union-find. The joined regions are numbered in tile order, and within a tile in
+/// order of their first span.
+///
+/// @see rcBuildColumnConnections, rcBuildContours
+bool rcBuildColumnRegions(rcContext* ctx, rcColumnHeightfield& chf)
+{
+	rcAssert(ctx);
+	rcAssert(chf.cons);
+
+	rcFree(chf.regs);
+	chf.regs = 0;
+	chf.maxRegions = 0;
+
+	rcRegionTask task;
+	task.chf = &chf;
+	task.tilesX = (chf.width + RC_REGION_TILE - 1) / RC_REGION_TILE;
+	task.tilesY = (chf.height + RC_REGION_TILE - 1) / RC_REGION_TILE;
+	const int ntiles = task.tilesX*task.tilesY;
+
+	rcScopedDelete<unsigned int> labels(chf.spanCount + 1);
+	rcScopedDelete<unsigned int> tileFirst(ntiles + 1);
+	if (!labels || !tileFirst)
+	{
+		ctx->log(RC_LOG_ERROR, "rcBuildColumnRegions: Out of memory 'labels' (%d).", chf.spanCount + 1);
+		return false;
+	}
+	memset(labels, 0, sizeof(unsigned int)*(chf.spanCount + 1));
+	task.labels = labels;
+	task.tileFirst = tileFirst;
+	task.parents = 0;
+	task.ids = 0;
+
+	rcParallelFor(ntiles, 1, floodTiles, &task);
+
+	// Number the regions of all tiles one after the other, from 1.
+	unsigned int nregions = 0;
+	for (int t = 0; t < ntiles; ++t)
+	{
+		const unsigned int count = tileFirst[t];
+		tileFirst[t] = nregions;
+		nregions += count;
+	}
+	tileFirst[ntiles] = nregions;
+
+	rcScopedDelete<unsigned int> parents((int)nregions + 1);
+	rcScopedDelete<unsigned short> ids((int)nregions + 1);
+	if (!parents || !ids)
+	{
+		ctx->log(RC_LOG_ERROR, "rcBuildColumnRegions: Out of memory 'parents' (%u).", nregions + 1);
+		return false;
+	}
+	for (unsigned int r = 0; r <= nregions; ++r)
+		parents[r] = r;
+	task.parents = parents;
+
+	rcParallelFor(ntiles, 1, joinTileRegions, &task);
+
+	// Join the regions across the borders of every tile, from both sides, since a
+	// connection may only lead one way across.
+	for (int y = 0; y < chf.height; ++y)
+	{
+		const int ty = y % RC_REGION_TILE;
+		const bool borderRow = ty == 0 || ty == RC_REGION_TILE - 1;
+		for (int x = 0; x < chf.width; ++x)
+		{
+			const int tx = x % RC_REGION_TILE;
+			if (!borderRow && tx != 0 && tx != RC_REGION_TILE - 1)
+			{
+				// Jump to the last column of the tile.
+				x += RC_REGION_TILE - 2 - tx;
+				continue;
+			}
+			const int c = x + y*chf.width;
+			const int t = tileIndex(task, x, y);
+			for (unsigned int i = chf.cells[c]; i < chf.cells[c + 1]; ++i)
+			{
+				if (labels[i] == 0)
+					continue;
+				for (int dir = 0; dir < 4; ++dir)
+				{
+					const int ni = rcGetColumnNeighbour(chf, x, y, i, dir);
+					if (ni < 0 || labels[ni] == 0 || chf.areas[ni] != chf.areas[i])
+						continue;
+					const int nt = tileIndex(task, x + rcGetDirOffsetX(dir), y + rcGetDirOffsetY(dir));
+					if (nt != t)
+						joinRegions(parents, tileFirst[t] + labels[i], tileFirst[nt] + labels[ni]);
+				}
+			}
+		}
+	}
+
+	// The roots are the lowest region of their set, so they are numbered before the rest.
+	unsigned int nids = 0;
+	ids[0] = 0;
+	for (unsigned int r = 1; r <= nregions; ++r)
+	{
+		const unsigned int root = findRoot(parents, r);
+		if (root == r)
+		{
+			if (nids == 0xffff)
+			{
+				ctx->log(RC_LOG_ERROR, "rcBuildColumnRegions: Region ID overflow, more than %d regions. "
+					"Raise the cell size or filter the input.", 0xffff);
+				return false;
+			}
+			ids[r] = (unsigned short)++nids;
+		}
+		else
+		{
+			ids[r] = ids[root];
+		}
+	}
+	task.ids = ids;
+
+	chf.regs = (unsigned short*)rcAlloc(sizeof(unsigned short)*(chf.spanCount + 1), RC_ALLOC_PERM);
+	if (!chf.regs)
+	{
+		ctx->log(RC_LOG_ERROR, "rcBuildColumnRegions: Out of memory 'regs' (%d).", chf.spanCount + 1);
+		return false;
+	}
+	rcParallelFor(ntiles, 1, relabelTiles, &task);
+	chf.maxRegions = (unsigned short)nids;
+	return true;
+}
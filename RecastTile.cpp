@@ -0,0 +1,163 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+#include <stdio.h>
+
+#include "RecastTile.h"
+
+static bool writeValue(FILE* fp, const void* data, const size_t size)
+{
+	return fwrite(data, size, 1, fp) == 1;
+}
+
+static bool readValue(FILE* fp, void* data, const size_t size)
+{
+	return fread(data, size, 1, fp) == 1;
+}
+
+template<class Layout>
+bool rcWriteTile(const char* path, const rcHeightfieldT<Layout>& hf, const int x0, const int y0,
+				 const int width, const int height, const int tx, const int ty, const int border)
+{
+	if (x0 < 0 || y0 < 0 || x0 + width > hf.width || y0 + height > hf.height)
+		return false;
+
+	rcTileHeader header;
+	header.magic = RC_TILE_MAGIC;
+	header.version = RC_TILE_VERSION;
+	header.heightBits = Layout::HeightBits;
+	header.tx = tx;
+	header.ty = ty;
+	header.border = border;
+	header.cellX = x0;
+	header.cellY = y0;
+	header.width = width;
+	header.height = height;
+	header.bmin[0] = hf.bmin[0] + x0*hf.cs;
+	header.bmin[1] = hf.bmin[1];
+	header.bmin[2] = hf.bmin[2] + y0*hf.cs;
+	header.bmax[0] = hf.bmin[0] + (x0 + width)*hf.cs;
+	header.bmax[1] = hf.bmax[1];
+	header.bmax[2] = hf.bmin[2] + (y0 + height)*hf.cs;
+	header.cs = hf.cs;
+	header.ch = hf.ch;
+	header.spanCount = 0;
+	for (int y = y0; y < y0 + height; ++y)
+		for (int x = x0; x < x0 + width; ++x)
+			for (const rcSpanT<Layout>* s = rcGetColumn(hf, x, y); s; s = s->next)
+				header.spanCount++;
+
+	FILE* fp = fopen(path, "wb");
+	if (!fp)
+		return false;
+
+	bool ok = writeValue(fp, &header, sizeof(header));
+	for (int y = y0; y < y0 + height && ok; ++y)
+	{
+		for (int x = x0; x < x0 + width && ok; ++x)
+		{
+			const rcSpanT<Layout>* column = rcGetColumn(hf, x, y);
+			unsigned short count = 0;
+			for (const rcSpanT<Layout>* s = column; s; s = s->next)
+				count++;
+			ok = writeValue(fp, &count, sizeof(count));
+			for (const rcSpanT<Layout>* s = column; s && ok; s = s->next)
+			{
+				const unsigned short smin = (unsigned short)s->data.smin;
+				const unsigned short smax = (unsigned short)s->data.smax;
+				const unsigned char area = (unsigned char)s->data.area;
+				ok = writeValue(fp, &smin, sizeof(smin)) && writeValue(fp, &smax, sizeof(smax)) && writeValue(fp, &area, sizeof(area));
+			}
+		}
+	}
+
+	if (fclose(fp) != 0)
+		ok = false;
+	return ok;
+}
+
+static bool readHeader(FILE* fp, rcTileHeader& header)
+{
+	return readValue(fp, &header, sizeof(header)) &&
+		header.magic == RC_TILE_MAGIC && header.version == RC_TILE_VERSION &&
+		header.width > 0 && header.height > 0;
+}
+
+bool rcReadTileHeader(const char* path, rcTileHeader& header)
+{
+	FILE* fp = fopen(path, "rb");
+	if (!fp)
+		return false;
+	const bool ok = readHeader(fp, header);
+	fclose(fp);
+	return ok;
+}
+
+template<class Layout>
+bool rcReadTile(const char* path, rcHeightfieldT<Layout>& hf, rcTileHeader& header)
+{
+	FILE* fp = fopen(path, "rb");
+	if (!fp)
+		return false;
+
+	bool ok = readHeader(fp, header) && header.heightBits <= Layout::HeightBits &&
+		rcCreateHeightfield(hf, header.width, header.height, header.bmin, header.bmax, header.cs, header.ch);
+	for (int y = 0; y < header.height && ok; ++y)
+	{
+		for (int x = 0; x < header.width && ok; ++x)
+		{
+			unsigned short count = 0;
+			ok = readValue(fp, &count, sizeof(count));
+			for (int i = 0; i < count && ok; ++i)
+			{
+				unsigned short smin, smax;
+				unsigned char area;
+				ok = readValue(fp, &smin, sizeof(smin)) && readValue(fp, &smax, sizeof(smax)) && readValue(fp, &area, sizeof(area));
+				// Spans are stored sorted and apart, so adding them never merges.
+				if (ok)
+					ok = rcAddSpan(hf, x, y, smin, smax, area, 0);
+			}
+		}
+	}
+
+	fclose(fp);
+	return ok;
+}
+
+#define RC_INSTANTIATE_TILE(Layout) \
+	template bool rcWriteTile<Layout>(const char*, const rcHeightfieldT<Layout>&, const int, const int, \
+		const int, const int, const int, const int, const int); \
+	template bool rcReadTile<Layout>(const char*, rcHeightfieldT<Layout>&, rcTileHeader&);
+RC_FOR_EACH_SPAN_LAYOUT(RC_INSTANTIATE_TILE)
@@ -0,0 +1,92 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+#ifndef RECASTTILE_H
+#define RECASTTILE_H
+
+#include "Recast.h"
+
+static const int RC_TILE_MAGIC = 'R'<<24 | 'C'<<16 | 'H'<<8 | 'T';
+static const int RC_TILE_VERSION = 1;
+
+/// Header of a heightfield tile file.
+/// The header is followed by every column of the tile in row major order, each a
+/// 16-bit span count and then the spans as 16-bit smin, 16-bit smax and 8-bit area.
+struct rcTileHeader
+{
+	int magic;			///< #RC_TILE_MAGIC
+	int version;		///< #RC_TILE_VERSION
+	int heightBits;		///< The span height bits of the layout the tile was baked with.
+	int tx;				///< The tile x coordinate.
+	int ty;				///< The tile y coordinate.
+	int border;			///< The number of overlap cells on each side of the tile.
+	int cellX;			///< The first column of the tile in the full grid, including the border. [Units: vx]
+	int cellY;			///< The first row of the tile in the full grid, including the border. [Units: vx]
+	int width;			///< The width of the tile, including the border. [Units: vx]
+	int height;			///< The height of the tile, including the border. [Units: vx]
+	float bmin[3];		///< The minimum bounds of the tile, including the border. [(x, y, z)]
+	float bmax[3];		///< The maximum bounds of the tile, including the border. [(x, y, z)]
+	float cs;			///< The size of each cell. (On the xz-plane.)
+	float ch;			///< The height of each cell. (The minimum increment along the y-axis.)
+	int spanCount;		///< The number of spans in the tile.
+};
+
+/// Writes a window of the heightfield as a tile file.
+/// Tiles are rasterized in the frame of the full grid, so that their cells come out
+/// exactly as in a single bake, and only their window is written.
+///  @param[in]		path			The file to write.
+///  @param[in]		hf				The heightfield, in the frame of the full grid.
+///  @param[in]		x0, y0			The first cell of the window, including the border.
+///  @param[in]		width, height	The size of the window, including the border. [Units: vx]
+///  @param[in]		tx, ty			The tile coordinates.
+///  @param[in]		border			The number of overlap cells on each side of the tile.
+///  @return False if the file could not be written.
+template<class Layout>
+bool rcWriteTile(const char* path, const rcHeightfieldT<Layout>& hf, const int x0, const int y0,
+				 const int width, const int height, const int tx, const int ty, const int border);
+
+/// Reads the header of a tile file.
+///  @return False if the file could not be read or is not a tile file.
+bool rcReadTileHeader(const char* path, rcTileHeader& header);
+
+/// Reads a tile file into an allocated, uninitialized heightfield.
+///  @param[in]		path	The file to read.
+///  @param[out]	hf		The heightfield, created with the window of the tile as its grid.
+///  @param[out]	header	The tile header.
+///  @return False if the file could not be read or its spans do not fit @p Layout.
+template<class Layout>
+bool rcReadTile(const char* path, rcHeightfieldT<Layout>& hf, rcTileHeader& header);
+
+#endif
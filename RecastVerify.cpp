@@ -0,0 +1,222 @@
+/*
+* Houdini tools based on HDK and Recast(Epic Games modified version).
+ *
+ * Copyright (c) 
+ *	2021 Side Effects Software Inc.
+ *	Epic Games, Inc.
+ *	2009-2010 Mikko Mononen memon@inside.org
+ *	2023 Bairuo https://www.zhihu.com/people/Bairuo
+ *
+ * Redistribution and use of hdk-recast in source and
+ * 
+ * binary forms, with or without modification, are permitted provided that the
+ * following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. The name of Side Effects Software may not be used to endorse or
+ *    promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIDE EFFECTS SOFTWARE `AS IS' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN
+ * NO EVENT SHALL SIDE EFFECTS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *----------------------------------------------------------------------------
+ */
+
+
+
+#include <math.h>
+
+#include "Recast.h"
+#include "RecastMath.h"
+#include "RecastAlloc.h"
+
+/// Moves the spans of the column back to the free list.
+template<class Layout>
+static void clearColumn(rcHeightfieldT<Layout>& hf, const int x, const int y)
+{
+	rcSpanBrickT<Layout>* brick = hf.bricks[rcBrickIndex(hf, x, y)];
+	if (!brick)
+		return;
+	rcSpanT<Layout>** column = &brick->spans[rcBrickColumnIndex(x & RC_BRICK_MASK, y & RC_BRICK_MASK)];
+	while (*column)
+	{
+		rcSpanT<Layout>* s = *column;
+		*column = s->next;
+		s->next = hf.freelist;
+		hf.freelist = s;
+	}
+	brick->rowMask[y & RC_BRICK_MASK] &= ~(1u << (x & RC_BRICK_MASK));
+}
+
+template<class Layout>
+bool rcCheckRasterizer(const float* verts, const int /*nv*/, const int* tris, const int nt,
+					   const int width, const int height, const float* bmin, const float* bmax,
+					   const float cs, const float ch, const int tolerance, rcRasterizerCheck& result)
+{
+	rcHeightfieldT<Layout>* hf = rcAllocHeightfield<Layout>();
+	if (!hf)
+		return false;
+	if (!rcCreateHeightfield(*hf, width, height, bmin, bmax, cs, ch))
+	{
+		rcFreeHeightField(hf);
+		return false;
+	}
+
+	const float ics = 1.0f / cs;
+	const float ich = 1.0f / ch;
+
+	for (int i = 0; i < nt; ++i)
+	{
+		const float* v0 = &verts[tris[i*3+0]*3];
+		const float* v1 = &verts[tris[i*3+1]*3];
+		const float* v2 = &verts[tris[i*3+2]*3];
+
+		// Each triangle goes into an empty heightfield, so every column holds at most one span.
+		if (!rasterizeTri(v0, v1, v2, RC_WALKABLE_AREA, *hf, hf->bmin, hf->bmax, cs, ics, ich, -1, 0, 0))
+		{
+			rcFreeHeightField(hf);
+			return false;
+		}
+		result.triangles++;
+
+		// The rasterizer may touch one cell past the triangle bounds.
+		const int x0 = rcMax((int)floorf((rcMin(v0[0], rcMin(v1[0], v2[0])) - bmin[0]) * ics) - 1, 0);
+		const int x1 = rcMin((int)floorf((rcMax(v0[0], rcMax(v1[0], v2[0])) - bmin[0]) * ics) + 1, width - 1);
+		const int y0 = rcMax((int)floorf((rcMin(v0[2], rcMin(v1[2], v2[2])) - bmin[2]) * ics) - 1, 0);
+		const int y1 = rcMin((int)floorf((rcMax(v0[2], rcMax(v1[2], v2[2])) - bmin[2]) * ics) + 1, height - 1);
+
+		for (int y = y0; y <= y1; ++y)
+		{
+			for (int x = x0; x <= x1; ++x)
+			{
+				const rcSpanT<Layout>* s = rcGetColumn(*hf, x, y);
+				int smin, smax;
+				if (!rcRasterizeTriCell(v0, v1, v2, *hf, x, y, smin, smax))
+				{
+					if (s)
+						result.extra++;
+					continue;
+				}
+
+				result.cells++;
+				if (!s)
+				{
+					result.missing++;
+					continue;
+				}
+
+				const int error = rcMax(rcAbs(smin - (int)s->data.smin), rcAbs(smax - (int)s->data.smax));
+				result.maxError = rcMax(result.maxError, error);
+				if (error > tolerance)
+					result.mismatched++;
+			}
+		}
+
+		for (int y = y0; y <= y1; ++y)
+			for (int x = x0; x <= x1; ++x)
+				clearColumn(*hf, x, y);
+	}
+
+	rcFreeHeightField(hf);
+	return true;
+}
+
+/// Deterministic random numbers, so a failing seed can be replayed.
+struct rcFuzzRandom
+{
+	unsigned int state;
+
+	float next()
+	{
+		state = state * 1664525u + 1013904223u;
+		return (float)(state >> 8) / 16777216.0f;
+	}
+	float range(const float lo, const float hi) { return lo + (hi - lo) * next(); }
+};
+
+template<class Layout>
+bool rcFuzzRasterizer(const unsigned int seed, const int nt, const int tolerance, rcRasterizerCheck& result)
+{
+	const int width = 64;
+	const int height = 48;
+	const float cs = 0.25f;
+	const float ch = 0.1f;
+	const float bmin[3] = { 0.0f, 0.0f, 0.0f };
+	const float bmax[3] = { width * cs, 8.0f, height * cs };
+
+	rcFuzzRandom rnd = { seed };
+	float* verts = (float*)rcAlloc(sizeof(float) * nt * 9, RC_ALLOC_TEMP);
+	int* tris = (int*)rcAlloc(sizeof(int) * nt * 3, RC_ALLOC_TEMP);
+	if (!verts || !tris)
+	{
+		rcFree(verts);
+		rcFree(tris);
+		return false;
+	}
+
+	for (int i = 0; i < nt; ++i)
+	{
+		float* v = &verts[i*9];
+		// Keep the centers inside a margin so some triangles cross the bounds.
+		const float c[3] = { rnd.range(-1.0f, bmax[0] + 1.0f), rnd.range(-1.0f, bmax[1] + 1.0f), rnd.range(-1.0f, bmax[2] + 1.0f) };
+		const int kind = i % 8;
+		const float size = kind == 1 ? cs * 0.5f : (kind == 0 ? 4.0f : 1.0f);
+		for (int k = 0; k < 3; ++k)
+		{
+			v[k*3+0] = c[0] + rnd.range(-size, size);
+			v[k*3+1] = c[1] + rnd.range(-size, size);
+			v[k*3+2] = c[2] + rnd.range(-size, size);
+		}
+
+		switch (kind)
+		{
+		case 2:		// Flat.
+			v[4] = v[7] = v[1];
+			break;
+		case 3:		// Vertical, no area on the xz-plane.
+			v[6] = v[0] + (v[3] - v[0]) * 0.25f;
+			v[8] = v[2] + (v[5] - v[2]) * 0.25f;
+			break;
+		case 4:		// Repeated vertex.
+			rcVcopy(&v[6], &v[3]);
+			break;
+		case 5:		// Vertices on cell boundaries.
+			for (int k = 0; k < 3; ++k)
+			{
+				v[k*3+0] = floorf(v[k*3+0] / cs) * cs;
+				v[k*3+2] = floorf(v[k*3+2] / cs) * cs;
+			}
+			break;
+		case 6:		// Sliver.
+			v[6] = v[0] + (v[3] - v[0]) * 0.5f + cs * 0.01f;
+			v[8] = v[2] + (v[5] - v[2]) * 0.5f;
+			break;
+		default:
+			break;
+		}
+
+		tris[i*3+0] = i*3+0;
+		tris[i*3+1] = i*3+1;
+		tris[i*3+2] = i*3+2;
+	}
+
+	const bool ok = rcCheckRasterizer<Layout>(verts, nt*3, tris, nt, width, height, bmin, bmax, cs, ch, tolerance, result);
+	rcFree(verts);
+	rcFree(tris);
+	return ok;
+}
+
+#define RC_INSTANTIATE_VERIFY(Layout) \
+	template bool rcCheckRasterizer<Layout>(const float*, const int, const int*, const int, const int, const int, \
+		const float*, const float*, const float, const float, const int, rcRasterizerCheck&); \
+	template bool rcFuzzRasterizer<Layout>(const unsigned int, const int, const int, rcRasterizerCheck&);
+RC_FOR_EACH_SPAN_LAYOUT(RC_INSTANTIATE_VERIFY)
@@ -54,7 +54,7 @@ public:
 
     static const UT_StringHolder theSOPTypeName;
     
-    //const SOP_NodeVerb *cookVerb() const override;
+    const SOP_NodeVerb *cookVerb() const override;
 
 protected:
     SOP_RecastRasterization(OP_Network *net, const char *name, OP_Operator *op)
@@ -67,10 +67,13 @@ protected:
     
     ~SOP_RecastRasterization() override {}
 
-    void addBox(const UT_Vector3 &vmin, const UT_Vector3 &vmax);
+    const char *inputLabel(unsigned idx) const override;
 
     /// Since this SOP implements a verb, cookMySop just delegates to the verb.
-    virtual OP_ERROR cookMySop(OP_Context &context) override;
+    OP_ERROR cookMySop(OP_Context &context) override
+    {
+        return cookMyselfAsVerb(context);
+    }
 };
 } // End HDK_Recast namespace
 